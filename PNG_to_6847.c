@@ -4,12 +4,30 @@
 #include <math.h>
 #include <complex.h>
 #include "lodepng.h"
+#include "fft.h"
+#include "thread_pool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CG3_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 #define PI 3.14159265358979323846
 
 #define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))
 #define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
 
+//min_rms_error never exceeds sqrt(4 * 3 * 255^2) = 884
+#define CG3_ERROR_BUCKETS 1024
+
+//-THREADS limit, beyond any core count this would run on
+#define MAX_THREADS 256
+
+//storage formats of a split_spectrum, see -PRECISION
+#define SPECTRUM_FLOAT 0
+#define SPECTRUM_HALF 1	//IEEE binary16, the spectrum is normalized so it stays in range and needs no scale
+#define SPECTRUM_INT16 2	//int16 with one float scale per row per TRANSPOSE_BLOCK columns
+
 const char cg3_string[] = ".cg3";
 const char png_string[] = ".png";
 const char source_string[] = "-SOURCE";
@@ -18,13 +36,25 @@ const char scaled_string[] = "-SCALED";
 const char magnitude_string[] = "-MAGNITUDE";
 const char preview_string[] = "-PREVIEW";
 const char debug_string[] = "-DEBUG";
+const char wisdom_string[] = "-WISDOM";
+const char tune_string[] = "-TUNE";
+const char threads_string[] = "-THREADS";
+const char precision_string[] = "-PRECISION";
+const char resample_string[] = "-RESAMPLE";
+const char decimate_string[] = "-DECIMATE";
 
 uint8_t source_index = 0;
 uint8_t out_index = 0;
 uint8_t scaled_index = 0;
 uint8_t magnitude_index = 0;
 uint8_t preview_index = 0;
+uint8_t wisdom_index = 0;
 uint8_t debug_enable;
+uint8_t tune_enable;
+unsigned int num_threads = 1;
+unsigned int spectrum_precision = SPECTRUM_FLOAT;
+unsigned int resample_index = 0;	//into resample_filters, 0 is the DFT
+unsigned int decimate_factor = 0;	//0 is off
 
 uint8_t CG3_PALETTE[] =
 {
@@ -38,19 +68,26 @@ uint8_t CG3_PALETTE[] =
 	//0xff, 0x80, 0x00,	// ORANGE
 };
 
-typedef struct CG3_ELEMENT
+//errors fit in 10 bits (see CG3_ERROR_BUCKETS), each plane is indexed by element = y * 128 + x
+typedef struct CG3_ELEMENTS
 {
-	unsigned int rms_error[4];
-	unsigned int min_rms_error;
-	uint8_t source_offset_y;
-	uint8_t source_offset_x;
-} cg3_element;
+	uint16_t rms_error[4][12288];	//one error plane per palette entry
+	uint16_t order[12288];	//element indices in ascending order of their smallest error
+} cg3_elements;
 
-typedef struct CG3_HEAP
+//SSE of a block against a constant color c is sum_square - 2 * c . sum + count * |c|^2
+//stored as planes so the error kernels can stream them
+typedef struct CG3_MOMENTS
 {
-	cg3_element* elements;
-	unsigned int size;
-} cg3_heap;
+	uint32_t sum_red[12288];	//per channel sums over each block
+	uint32_t sum_green[12288];
+	uint32_t sum_blue[12288];
+	uint32_t sum_square[12288];	//sum of squares over the block and all channels
+	unsigned int count;	//pixels per block, the same for every element
+} cg3_moments;
+
+//fills the error planes for elements first to last - 1
+typedef void (*cg3_error_kernel)(cg3_moments* moments, unsigned int first, unsigned int last, cg3_elements* elements);
 
 typedef struct PIXEL_IMAGE
 {
@@ -61,6 +98,23 @@ typedef struct PIXEL_IMAGE
 	unsigned int height;
 } pixel_image;
 
+//Spectra are stored as separate real and imaginary planes so that the 2D passes and the
+//magnitude plot work on plain float arrays. The 1D transforms still run on a small interleaved
+//batch of columns, moved in and out of the planes TRANSPOSE_BLOCK columns at a time.
+//With SPECTRUM_HALF or SPECTRUM_INT16 the planes are packed 16 bit values instead (real and imag
+//are NULL) and the batches are unpacked to float, so only the storage loses precision.
+typedef struct SPLIT_SPECTRUM
+{
+	float* real;
+	float* imag;
+	uint16_t* packed_real;
+	uint16_t* packed_imag;
+	float* scales;	//SPECTRUM_INT16 only
+	unsigned int height;
+	unsigned int width;
+	unsigned int precision;
+} split_spectrum;
+
 int str_comp_partial(const char* str1, const char* str2)
 {
 	for(int i = 0; str1[i] && str2[i]; ++i)
@@ -71,6 +125,18 @@ int str_comp_partial(const char* str1, const char* str2)
 	return 1;
 }
 
+//whole string compare, for option values that must name a mode exactly
+int str_comp(const char* str1, const char* str2)
+{
+	int i = 0;
+	for(; str1[i] && str2[i]; ++i)
+	{
+		if(str1[i] != str2[i])
+			return 0;
+	}
+	return str1[i] == str2[i];
+}
+
 void to_caps(char* str)
 {
 	unsigned int d = 0;
@@ -112,6 +178,17 @@ void to_caps(char* str)
 	return;
 }
 
+//the value following the option at *arg, which is moved to it, exits if the option is the last argument
+char* option_value(int argc, char** argv, unsigned int* arg)
+{
+	if(*arg + 1 >= (unsigned int)argc)
+	{
+		printf("Invalid arguments!\n");
+		exit(1);
+	}
+	return argv[++*arg];
+}
+
 void replace_file_extension(char* new_ext, char* out_name, char* new_name)
 {
 	uint8_t count = 0;
@@ -201,94 +278,188 @@ void fill_RGBA_image(unsigned char* output_image, pixel_image* input_image)
 	}
 }
 
-void create_cg3_elements(cg3_element* output_elements, pixel_image* input_image)
+//input_image covers the 128x96 element grid with blocks of (width / 128) x (height / 96) pixels,
+//one sample per element for the native grid, 2x2 blocks for a 256x192 image
+void create_cg3_moments(cg3_moments* output_moments, pixel_image* input_image)
 {
+	unsigned int block_height = input_image->height / 96;
+	unsigned int block_width = input_image->width / 128;
 	unsigned int element_offset = 0;
-	unsigned int rms_error;
-	unsigned int min_rms_error;
-	unsigned int diff_square;
-	for(unsigned int y = 0; y < input_image->height; y = y + 2)
+	output_moments->count = block_height * block_width;
+	for(unsigned int y = 0; y < 96; ++y)
 	{
-		for(unsigned int x = 0; x < input_image->width; x = x + 2)
+		for(unsigned int x = 0; x < 128; ++x)
 		{
-			min_rms_error = 0xffffffff;
-			for(unsigned int palette_index = 0; palette_index < 4; ++palette_index)
+			uint32_t sum_red = 0;
+			uint32_t sum_green = 0;
+			uint32_t sum_blue = 0;
+			uint32_t sum_square = 0;
+			for(unsigned int by = y * block_height; by < (y + 1) * block_height; ++by)
 			{
-				//compute total diff_square
-				//red diff
-				diff_square = (unsigned int)pow((double)((int)(input_image->pixels_red[y][x]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_red[y][x + 1]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_red[y + 1][x]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_red[y + 1][x + 1]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-				//green diff
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y][x]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y + 1][x]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y + 1][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-				//blue diff
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y][x]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y + 1][x]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-				diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y + 1][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-				rms_error = (unsigned int)(sqrt((double)diff_square) + 0.5);
-				output_elements[element_offset].rms_error[palette_index] = rms_error;
-				if(rms_error < min_rms_error)
+				for(unsigned int bx = x * block_width; bx < (x + 1) * block_width; ++bx)
 				{
-					min_rms_error = rms_error;
+					uint32_t red = input_image->pixels_red[by][bx];
+					uint32_t green = input_image->pixels_green[by][bx];
+					uint32_t blue = input_image->pixels_blue[by][bx];
+					sum_red += red;
+					sum_green += green;
+					sum_blue += blue;
+					sum_square += red * red + green * green + blue * blue;
 				}
 			}
-			output_elements[element_offset].min_rms_error = min_rms_error;
-			output_elements[element_offset].source_offset_y = y;
-			output_elements[element_offset].source_offset_x = x;
+			output_moments->sum_red[element_offset] = sum_red;
+			output_moments->sum_green[element_offset] = sum_green;
+			output_moments->sum_blue[element_offset] = sum_blue;
+			output_moments->sum_square[element_offset] = sum_square;
 			++element_offset;
 		}
 	}
 }
 
-void create_cg3_output(uint8_t* cg3_output, cg3_element* input_elements, pixel_image* input_image)
+//RMS error of a 2x2 block, a block of any other size is scaled to four pixels (exact for 1x1)
+unsigned int cg3_rms_error(cg3_moments* moments, unsigned int element, unsigned int palette_index)
+{
+	int palette_red = CG3_PALETTE[palette_index * 3];
+	int palette_green = CG3_PALETTE[palette_index * 3 + 1];
+	int palette_blue = CG3_PALETTE[palette_index * 3 + 2];
+	int cross = palette_red * (int)moments->sum_red[element] + palette_green * (int)moments->sum_green[element] + palette_blue * (int)moments->sum_blue[element];
+	int norm = palette_red * palette_red + palette_green * palette_green + palette_blue * palette_blue;
+	unsigned int diff_square = (unsigned int)((int)moments->sum_square[element] - 2 * cross + (int)moments->count * norm);
+	diff_square = (diff_square * 4) / moments->count;
+	return (unsigned int)(sqrt((double)diff_square) + 0.5);
+}
+
+void cg3_errors_scalar(cg3_moments* moments, unsigned int first, unsigned int last, cg3_elements* elements)
+{
+	for(unsigned int element = first; element < last; ++element)
+	{
+		for(unsigned int palette_index = 0; palette_index < 4; ++palette_index)
+		{
+			elements->rms_error[palette_index][element] = cg3_rms_error(moments, element, palette_index);
+		}
+	}
+}
+
+#ifdef CG3_X86_KERNELS
+//The vector kernels work in float: for blocks of up to 4 pixels every intermediate is an integer below 2^24,
+//so the squared error is exact. sqrt(d) + 0.5 is then truncated and nudged by one where needed so that
+//r - 0.5 <= sqrt(d) < r + 0.5 holds exactly, the same rounding as the scalar code.
+__attribute__((target("sse2")))
+void cg3_errors_sse2(cg3_moments* moments, unsigned int first, unsigned int last, cg3_elements* elements)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 scale = _mm_set1_ps(4.0f / (float)moments->count);
+	const __m128 count = _mm_set1_ps((float)moments->count);
+	unsigned int element = first;
+	for(; element + 4 <= last; element = element + 4)
+	{
+		__m128 sum_red = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i*)(moments->sum_red + element)));
+		__m128 sum_green = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i*)(moments->sum_green + element)));
+		__m128 sum_blue = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i*)(moments->sum_blue + element)));
+		__m128 sum_square = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i*)(moments->sum_square + element)));
+		for(unsigned int palette_index = 0; palette_index < 4; ++palette_index)
+		{
+			float palette_red = CG3_PALETTE[palette_index * 3];
+			float palette_green = CG3_PALETTE[palette_index * 3 + 1];
+			float palette_blue = CG3_PALETTE[palette_index * 3 + 2];
+			float norm = palette_red * palette_red + palette_green * palette_green + palette_blue * palette_blue;
+			__m128 cross = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sum_red, _mm_set1_ps(2.0f * palette_red)), _mm_mul_ps(sum_green, _mm_set1_ps(2.0f * palette_green))), _mm_mul_ps(sum_blue, _mm_set1_ps(2.0f * palette_blue)));
+			__m128 diff_square = _mm_mul_ps(_mm_add_ps(_mm_sub_ps(sum_square, cross), _mm_mul_ps(count, _mm_set1_ps(norm))), scale);
+			__m128 rms_error = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(_mm_sqrt_ps(diff_square), half)));
+			__m128 square = _mm_mul_ps(rms_error, rms_error);
+			__m128 too_low = _mm_cmpgt_ps(diff_square, _mm_add_ps(square, rms_error));
+			__m128 too_high = _mm_and_ps(_mm_cmple_ps(diff_square, _mm_sub_ps(square, rms_error)), _mm_cmpge_ps(rms_error, one));
+			rms_error = _mm_sub_ps(_mm_add_ps(rms_error, _mm_and_ps(too_low, one)), _mm_and_ps(too_high, one));
+			__m128i rms_error_32 = _mm_cvttps_epi32(rms_error);
+			_mm_storel_epi64((__m128i*)(elements->rms_error[palette_index] + element), _mm_packs_epi32(rms_error_32, rms_error_32));
+		}
+	}
+	cg3_errors_scalar(moments, element, last, elements);
+}
+
+__attribute__((target("avx2")))
+void cg3_errors_avx2(cg3_moments* moments, unsigned int first, unsigned int last, cg3_elements* elements)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 scale = _mm256_set1_ps(4.0f / (float)moments->count);
+	const __m256 count = _mm256_set1_ps((float)moments->count);
+	unsigned int element = first;
+	for(; element + 8 <= last; element = element + 8)
+	{
+		__m256 sum_red = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i*)(moments->sum_red + element)));
+		__m256 sum_green = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i*)(moments->sum_green + element)));
+		__m256 sum_blue = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i*)(moments->sum_blue + element)));
+		__m256 sum_square = _mm256_cvtepi32_ps(_mm256_loadu_si256((__m256i*)(moments->sum_square + element)));
+		for(unsigned int palette_index = 0; palette_index < 4; ++palette_index)
+		{
+			float palette_red = CG3_PALETTE[palette_index * 3];
+			float palette_green = CG3_PALETTE[palette_index * 3 + 1];
+			float palette_blue = CG3_PALETTE[palette_index * 3 + 2];
+			float norm = palette_red * palette_red + palette_green * palette_green + palette_blue * palette_blue;
+			__m256 cross = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sum_red, _mm256_set1_ps(2.0f * palette_red)), _mm256_mul_ps(sum_green, _mm256_set1_ps(2.0f * palette_green))), _mm256_mul_ps(sum_blue, _mm256_set1_ps(2.0f * palette_blue)));
+			__m256 diff_square = _mm256_mul_ps(_mm256_add_ps(_mm256_sub_ps(sum_square, cross), _mm256_mul_ps(count, _mm256_set1_ps(norm))), scale);
+			__m256 rms_error = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_add_ps(_mm256_sqrt_ps(diff_square), half)));
+			__m256 square = _mm256_mul_ps(rms_error, rms_error);
+			__m256 too_low = _mm256_cmp_ps(diff_square, _mm256_add_ps(square, rms_error), _CMP_GT_OQ);
+			__m256 too_high = _mm256_and_ps(_mm256_cmp_ps(diff_square, _mm256_sub_ps(square, rms_error), _CMP_LE_OQ), _mm256_cmp_ps(rms_error, one, _CMP_GE_OQ));
+			rms_error = _mm256_sub_ps(_mm256_add_ps(rms_error, _mm256_and_ps(too_low, one)), _mm256_and_ps(too_high, one));
+			__m256i rms_error_32 = _mm256_cvttps_epi32(rms_error);
+			_mm_storeu_si128((__m128i*)(elements->rms_error[palette_index] + element), _mm_packs_epi32(_mm256_castsi256_si128(rms_error_32), _mm256_extracti128_si256(rms_error_32, 1)));
+		}
+	}
+	cg3_errors_scalar(moments, element, last, elements);
+}
+#endif
+
+//the vector kernels need the float math to stay exact and the 4 / count scale to be a power of two
+cg3_error_kernel select_cg3_error_kernel(cg3_moments* moments)
+{
+	if((moments->count != 1) && (moments->count != 2) && (moments->count != 4))
+		return cg3_errors_scalar;
+#ifdef CG3_X86_KERNELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		return cg3_errors_avx2;
+	if(__builtin_cpu_supports("sse2"))
+		return cg3_errors_sse2;
+#endif
+	return cg3_errors_scalar;
+}
+
+void create_cg3_elements(cg3_elements* output_elements, cg3_moments* input_moments)
+{
+	cg3_error_kernel kernel = select_cg3_error_kernel(input_moments);
+	kernel(input_moments, 0, 12288, output_elements);
+}
+
+//input_elements carry the errors computed by create_cg3_elements and the order from cg3_sort,
+//only the error_offset bias is added here
+void create_cg3_output(uint8_t* cg3_output, cg3_elements* input_elements)
 {
 	unsigned int rms_error;
 	unsigned int min_rms_error;
-	unsigned int diff_square;
 	unsigned int error_offset[4] = {0, 0, 0, 0};
-	unsigned int x;
-	unsigned int y;
+	unsigned int element;
 	uint8_t best_match;
 	uint8_t output_byte;
 	uint8_t pair_offset;	//bit pair offset in output byte
 	unsigned int output_offset;
-	for(unsigned int element_offset = 0; element_offset < 12288; ++element_offset)
+	for(unsigned int order_offset = 0; order_offset < 12288; ++order_offset)
 	{
 		min_rms_error = (unsigned int)(-1);
-		x = input_elements[element_offset].source_offset_x;
-		y = input_elements[element_offset].source_offset_y;
+		element = input_elements->order[order_offset];
 		for(uint8_t palette_index = 0; palette_index < 4; ++palette_index)
 		{
-			//compute total diff_square
-			//red diff
-			diff_square = (unsigned int)pow((double)((int)(input_image->pixels_red[y][x]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_red[y][x + 1]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_red[y + 1][x]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_red[y + 1][x + 1]) - (int)(CG3_PALETTE[palette_index * 3])), 2);
-			//green diff
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y][x]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y + 1][x]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_green[y + 1][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 1])), 2);
-			//blue diff
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y][x]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y + 1][x]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-			diff_square += (unsigned int)pow((double)((int)(input_image->pixels_blue[y + 1][x + 1]) - (int)(CG3_PALETTE[palette_index * 3 + 2])), 2);
-			rms_error = (unsigned int)(sqrt((double)diff_square) + 0.5);
-			rms_error = rms_error + (error_offset[palette_index] >> 4);
+			rms_error = input_elements->rms_error[palette_index][element] + (error_offset[palette_index] >> 4);
 			if(rms_error < min_rms_error)
 			{
 				min_rms_error = rms_error;
 				best_match = palette_index;
 			}
 		}
-		output_offset = (y >> 1) * 128 + (x >> 1);	//recover element index
+		output_offset = element;
 		pair_offset = output_offset & 0x03;
 		pair_offset = pair_offset ^ 0x03;
 		pair_offset = pair_offset << 1;		//determine its position in the output byte
@@ -304,53 +475,40 @@ void create_cg3_output(uint8_t* cg3_output, cg3_element* input_elements, pixel_i
 	}
 }
 
-void cg3_heapify_down(cg3_heap* heap, unsigned int index)
+//the smallest of the element's 4 errors, the sort key. It is recomputed from the planes instead of
+//stored so that the elements are only the planes and the order.
+unsigned int cg3_min_rms_error(cg3_elements* elements, unsigned int element)
 {
-	unsigned int left_index;
-	unsigned int right_index;
-	unsigned int largest;
-	cg3_element temp;
-	while(1)
+	unsigned int min_rms_error = elements->rms_error[0][element];
+	for(unsigned int palette_index = 1; palette_index < 4; ++palette_index)
 	{
-		left_index = index * 2 + 1;
-		right_index = index * 2 + 2;
-		largest = index;
-		if((left_index < heap->size) && (heap->elements[left_index].min_rms_error > heap->elements[largest].min_rms_error))
-			largest = left_index;
-		if((right_index < heap->size) && (heap->elements[right_index].min_rms_error > heap->elements[largest].min_rms_error))
-			largest = right_index;
-		if(largest == index)
-			return;
-		temp = heap->elements[index];
-		heap->elements[index] = heap->elements[largest];
-		heap->elements[largest] = temp;
-		index = largest;
+		min_rms_error = MIN(min_rms_error, elements->rms_error[palette_index][element]);
 	}
+	return min_rms_error;
 }
 
-void cg3_heapify(cg3_heap* heap, cg3_element* elements, unsigned int size)
+//Counting sort on cg3_min_rms_error, ascending. Only the 16 bit element indices in order are written,
+//elements with equal errors keep their raster order. The heapsort this replaced left ties in no
+//particular order, and the quantizer's error offsets depend on the order it visits elements in,
+//so a .cg3 can differ from older builds in a few elements that tie.
+void cg3_sort(cg3_elements* elements)
 {
-	heap->size = size;
-	heap->elements = elements;
-	for(unsigned int index = size - 1; index != (unsigned int)(-1); --index)
+	unsigned int bucket_start[CG3_ERROR_BUCKETS + 1];
+	for(unsigned int d = 0; d <= CG3_ERROR_BUCKETS; ++d)
 	{
-		cg3_heapify_down(heap, index);
+		bucket_start[d] = 0;
 	}
-	return;
-}
-
-void cg3_heapsort(cg3_element* elements, unsigned int size)
-{
-	cg3_element temp;
-	cg3_heap heap;
-	cg3_heapify(&heap, elements, size);
-	for(unsigned int end = size - 1; end != (unsigned int)(-1); --end)
+	for(unsigned int d = 0; d < 12288; ++d)
+	{
+		++bucket_start[cg3_min_rms_error(elements, d) + 1];
+	}
+	for(unsigned int d = 1; d <= CG3_ERROR_BUCKETS; ++d)
+	{
+		bucket_start[d] = bucket_start[d] + bucket_start[d - 1];
+	}
+	for(unsigned int d = 0; d < 12288; ++d)
 	{
-		temp = elements[end];
-		elements[end] = elements[0];
-		elements[0] = temp;
-		--size;
-		cg3_heapify(&heap, elements, size);
+		elements->order[bucket_start[cg3_min_rms_error(elements, d)]++] = d;
 	}
 	return;
 }
@@ -387,32 +545,6 @@ void cg3_to_rgba(unsigned char* output_image, uint8_t* input_image)
 	}
 }
 
-void split_image(uint8_t* input, unsigned int height, unsigned int width, uint8_t* red, uint8_t* green, uint8_t* blue, uint8_t* alpha)
-{
-	if(alpha)
-	{
-		for(unsigned int d = 0; d < height * width; ++d)
-		{
-			unsigned int pixel = d << 2;
-			red[d] = input[pixel];
-			green[d] = input[pixel + 1];
-			blue[d] = input[pixel + 2];
-			alpha[d] = input[pixel + 3];
-		}
-	}
-	else
-	{
-		for(unsigned int d = 0; d < height * width; ++d)
-		{
-			unsigned int pixel = d << 2;
-			red[d] = input[pixel];
-			green[d] = input[pixel + 1];
-			blue[d] = input[pixel + 2];
-		}
-	}
-	return;
-}
-
 void merge_image(uint8_t* output, unsigned int height, unsigned int width, uint8_t* red, uint8_t* green, uint8_t* blue, uint8_t* alpha)
 {
 	if(alpha)
@@ -440,33 +572,120 @@ void merge_image(uint8_t* output, unsigned int height, unsigned int width, uint8
 	return;
 }
 
-void image_to_complex(uint8_t* input, unsigned int input_height, unsigned int input_width, float complex* output, unsigned int output_height, unsigned int output_width)
+//reads pixel index of a bit packed PNG row buffer, for bit depths below 8
+unsigned int read_packed_sample(const unsigned char* raw, size_t index, unsigned int bitdepth)
 {
-	unsigned int out_index;
-	unsigned int in_index;
-	for(unsigned int d = 0; d < input_height; ++d)
+	size_t bit = index * bitdepth;
+	return (raw[bit >> 3] >> (8 - bitdepth - (bit & 7))) & ((1u << bitdepth) - 1);
+}
+
+//Converts num_pixels raw PNG pixels in the file's own color mode to the red, green and blue planes.
+//The values are the ones lodepng's RGBA8 conversion gives: 16 bit samples keep their high byte,
+//low bit depth gray is scaled to 0-255 and palette indices past the palette are black.
+void raw_to_planes(const unsigned char* raw, size_t num_pixels, const LodePNGColorMode* mode, float** planes)
+{
+	float* red = planes[0];
+	float* green = planes[1];
+	float* blue = planes[2];
+	unsigned int sample_bytes = mode->bitdepth / 8;
+	unsigned int pixel_bytes = lodepng_get_channels(mode) * sample_bytes;
+	if(mode->colortype == LCT_RGB || mode->colortype == LCT_RGBA)
 	{
-		for(unsigned int i = 0; i < input_width; ++i)
+		for(size_t i = 0; i < num_pixels; ++i)
 		{
-			out_index = (output_width * d) + i;
-			in_index = (input_width * d) + i;
-			output[out_index] = input[in_index];
+			const unsigned char* pixel = raw + pixel_bytes * i;
+			red[i] = pixel[0];
+			green[i] = pixel[sample_bytes];
+			blue[i] = pixel[2 * sample_bytes];
 		}
-		for(unsigned int i = input_width; i < output_width; ++i)
+	}
+	else if(mode->bitdepth >= 8 && mode->colortype != LCT_PALETTE)	//gray or gray and alpha
+	{
+		for(size_t i = 0; i < num_pixels; ++i)
 		{
-			out_index = (output_width * d) + i;
-			output[out_index] = 0.0;
+			red[i] = green[i] = blue[i] = raw[pixel_bytes * i];
 		}
 	}
-	for(unsigned int d = input_height; d < output_height; ++d)
+	else if(mode->colortype == LCT_PALETTE)
 	{
-		for(unsigned int i = 0; i < output_width; ++i)
+		for(size_t i = 0; i < num_pixels; ++i)
 		{
-			out_index = (output_width * d) + i;
-			output[out_index] = 0.0;
+			unsigned int index = (mode->bitdepth == 8) ? raw[i] : read_packed_sample(raw, i, mode->bitdepth);
+			if(index < mode->palettesize)
+			{
+				red[i] = mode->palette[4 * index];
+				green[i] = mode->palette[4 * index + 1];
+				blue[i] = mode->palette[4 * index + 2];
+			}
+			else
+			{
+				red[i] = green[i] = blue[i] = 0.0f;
+			}
 		}
 	}
-	return;
+	else	//gray below 8 bits
+	{
+		unsigned int highest = (1u << mode->bitdepth) - 1;
+		for(size_t i = 0; i < num_pixels; ++i)
+		{
+			red[i] = green[i] = blue[i] = (read_packed_sample(raw, i, mode->bitdepth) * 255) / highest;
+		}
+	}
+}
+
+typedef struct PLANE_DECODER
+{
+	float** planes;
+	unsigned int width;
+	const LodePNGColorMode* mode;
+} plane_decoder;
+
+//lodepng_decode_rows callback, converts row y straight into the planes
+unsigned decode_plane_row(void* user, unsigned y, const unsigned char* row)
+{
+	plane_decoder* decoder = (plane_decoder*)user;
+	size_t offset = (size_t)y * decoder->width;
+	float* row_planes[3] = {decoder->planes[0] + offset, decoder->planes[1] + offset, decoder->planes[2] + offset};
+	raw_to_planes(row, decoder->width, decoder->mode, row_planes);
+	return 0;
+}
+
+//Decodes a PNG file into one float plane per color channel, alpha is dropped. lodepng hands over
+//the rows in the file's own color mode (color_convert off) as they are inflated, so besides the
+//compressed file only the planes are full size, not a raw image, an RGBA copy or 8 bit planes.
+//Returns a lodepng error code, the planes are only allocated on success.
+unsigned decode_png_planes(const char* filename, float** planes, unsigned int* width, unsigned int* height)
+{
+	unsigned char* file;
+	size_t file_size;
+	unsigned error = lodepng_load_file(&file, &file_size, filename);
+	if(error)
+		return error;
+	LodePNGState state;
+	lodepng_state_init(&state);
+	state.decoder.color_convert = 0;
+	error = lodepng_inspect(width, height, &state, file, file_size);
+	if(!error)
+	{
+		size_t num_pixels = (size_t)*width * *height;
+		for(unsigned int c = 0; c < 3; ++c)
+		{
+			planes[c] = (float*)malloc(sizeof(float) * num_pixels);
+		}
+		//info_raw gets the file's color mode, palette included, before the first row
+		plane_decoder decoder = {planes, *width, &state.info_raw};
+		error = lodepng_decode_rows(width, height, &state, file, file_size, decode_plane_row, &decoder);
+		if(error)
+		{
+			for(unsigned int c = 0; c < 3; ++c)
+			{
+				free(planes[c]);
+			}
+		}
+	}
+	free(file);
+	lodepng_state_cleanup(&state);
+	return error;
 }
 
 /*void complex_to_image(uint8_t* output, unsigned int output_height, unsigned int output_width, float complex* input, unsigned int input_height, unsigned int input_width)
@@ -485,7 +704,7 @@ void image_to_complex(uint8_t* input, unsigned int input_height, unsigned int in
 	return;
 }*/
 
-void complex_to_pixel_image(pixel_image output, float complex* input_red, float complex* input_green, float complex* input_blue)
+void real_to_pixel_image(pixel_image output, float* input_red, float* input_green, float* input_blue)
 {
 	unsigned int in_index;
 	for(unsigned int y = 0; y < output.height; ++y)
@@ -493,26 +712,9 @@ void complex_to_pixel_image(pixel_image output, float complex* input_red, float
 		for(unsigned int x = 0; x < output.width; ++x)
 		{
 			in_index = (output.width * y) + x;
-			output.pixels_red[y][x] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + crealf(input_red[in_index])))));
-			output.pixels_green[y][x] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + crealf(input_green[in_index])))));
-			output.pixels_blue[y][x] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + crealf(input_blue[in_index])))));
-		}
-	}
-	return;
-}
-
-void complex_to_magnitude_image(uint8_t* output, unsigned int height, unsigned int width, float complex* input)
-{
-	for(unsigned int d = 0; d < height; ++d)
-	{
-		for(unsigned int i = 0; i < width; ++i)
-		{
-			unsigned int y_index = (d + (height / 2)) % height;
-			unsigned int x_index = (i + (width / 2)) % width;
-			unsigned int in_index = width * d + i;
-			unsigned int out_index = width * y_index + x_index;
-			float magnitude = 128.0 + 23.0 * log(cabsf(input[in_index])/* / (float)(width * height)*/);
-			output[out_index] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + magnitude))));
+			output.pixels_red[y][x] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + input_red[in_index]))));
+			output.pixels_green[y][x] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + input_green[in_index]))));
+			output.pixels_blue[y][x] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + input_blue[in_index]))));
 		}
 	}
 	return;
@@ -520,468 +722,1301 @@ void complex_to_magnitude_image(uint8_t* output, unsigned int height, unsigned i
 
 void dft(float complex* input, unsigned int num_points, float complex* output)
 {
+	fft(input, num_points, output, FFT_FORWARD);
 	for(unsigned int freq = 0; freq < num_points; ++freq)
 	{
-		float complex temp = 0.0;
-		for(unsigned int point = 0; point < num_points; ++point)
-		{
-			float exp = 2.0 * PI * (float)freq * ((float)point / (float)num_points);
-			temp = temp + input[point] * (cos(exp) - I * sin(exp));
-		}
-		output[freq] = temp / (float)num_points;
+		output[freq] = output[freq] / (float)num_points;
 	}
 }
 
 void idft(float complex* input, unsigned int num_points, float complex* output)
 {
-	for(unsigned int point = 0; point < num_points; ++point)
+	fft(input, num_points, output, FFT_INVERSE);
+}
+
+void real_dft(float* input, unsigned int num_points, float complex* output)
+{
+	fft_r2c(input, num_points, output);
+	for(unsigned int freq = 0; freq <= num_points / 2; ++freq)
 	{
-		float complex temp = 0.0;
-		for(unsigned int freq = 0; freq < num_points; ++freq)
-		{
-			float exp = 2.0 * PI * (float)freq * ((float)point / (float)num_points);
-			temp = temp + input[freq] * (cos(exp) + I * sin(exp));
-		}
-		output[point] = temp;// / (float)num_points;
+		output[freq] = output[freq] / (float)num_points;
 	}
 }
 
-void dft_2d(float complex* input, unsigned int input_height, unsigned int input_width, float complex* output)
+void real_idft(float complex* input, unsigned int num_points, float* output)
 {
-	float complex* transformed = (float complex*)malloc(sizeof(float complex) * input_width * input_height);
+	fft_c2r(input, num_points, output);
+}
 
-	//transform the rows
-	printf("DFT: Transforming rows\n");
-	for(unsigned int d = 0; d < input_height; ++d)
+//Column transforms work on batches of TRANSPOSE_BLOCK columns. Moving a batch reads one short run
+//of each plane row and advances TRANSPOSE_BLOCK sequential batch columns, so the lines being
+//written stay in L1 instead of every value touching a new line as a whole-column copy would.
+#define TRANSPOSE_BLOCK 32
+
+void create_split_spectrum(split_spectrum* spectrum, unsigned int height, unsigned int width, unsigned int precision)
+{
+	spectrum->real = NULL;
+	spectrum->imag = NULL;
+	spectrum->packed_real = NULL;
+	spectrum->packed_imag = NULL;
+	spectrum->scales = NULL;
+	if(precision == SPECTRUM_FLOAT)
+	{
+		spectrum->real = (float*)malloc(sizeof(float) * width * height);
+		spectrum->imag = (float*)malloc(sizeof(float) * width * height);
+	}
+	else
 	{
-		unsigned int offset = input_width * d;
-		dft(input + offset, input_width, transformed + offset);
+		spectrum->packed_real = (uint16_t*)malloc(sizeof(uint16_t) * width * height);
+		spectrum->packed_imag = (uint16_t*)malloc(sizeof(uint16_t) * width * height);
 	}
+	if(precision == SPECTRUM_INT16)
+		spectrum->scales = (float*)malloc(sizeof(float) * height * ((width + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK));
+	spectrum->height = height;
+	spectrum->width = width;
+	spectrum->precision = precision;
+}
+
+void free_split_spectrum(split_spectrum* spectrum)
+{
+	free(spectrum->real);
+	free(spectrum->imag);
+	free(spectrum->packed_real);
+	free(spectrum->packed_imag);
+	free(spectrum->scales);
+}
+
+//round to nearest even, out of range values become infinity
+uint16_t float_to_half(float value)
+{
+	union {float f; uint32_t u;} bits = {value};
+	uint16_t sign = (bits.u >> 16) & 0x8000;
+	uint32_t magnitude = bits.u & 0x7FFFFFFF;
+	if(magnitude > 0x7F800000)	//NaN
+		return sign | 0x7E00;
+	if(magnitude >= 0x477FF000)	//65520 and up round past the largest half, 65504
+		return sign | 0x7C00;
+	if(magnitude < 0x38800000)	//below 2^-14 the half is subnormal, a multiple of 2^-24
+		return sign | (uint16_t)rintf(fabsf(value) * 16777216.0f);
+	//rebias the exponent and round away the low 13 mantissa bits
+	return sign | ((magnitude + 0xFFF + ((magnitude >> 13) & 1) - 0x38000000) >> 13);
+}
+
+float half_to_float(uint16_t value)
+{
+	unsigned int exponent = (value >> 10) & 0x1F;
+	unsigned int mantissa = value & 0x3FF;
+	union {uint32_t u; float f;} bits;
+	if(exponent == 0)
+		bits.f = (float)mantissa / 16777216.0f;
+	else if(exponent == 31)
+		bits.u = 0x7F800000 | (mantissa << 13);
+	else
+		bits.u = ((exponent + 112) << 23) | (mantissa << 13);
+	bits.u = bits.u | ((uint32_t)(value & 0x8000) << 16);
+	return bits.f;
+}
 
-	//transpose the array
-	printf("DFT: Transposing array\n");
-	float complex* transposed = (float complex*)malloc(sizeof(float complex) * input_width * input_height);
-	for(unsigned int d = 0; d < input_height; ++d)
+//Stores count values of row d starting at column first. With SPECTRUM_INT16 the values must be
+//a whole scale block (first a multiple of TRANSPOSE_BLOCK, count up to the end of the block),
+//the block's scale maps its largest component to 32767.
+void pack_split_segment(split_spectrum spectrum, unsigned int d, unsigned int first, unsigned int count, const float* real, const float* imag)
+{
+	unsigned int index = spectrum.width * d + first;
+	if(spectrum.precision == SPECTRUM_FLOAT)
 	{
-		for(unsigned int i = 0; i < input_width; ++i)
+		for(unsigned int i = 0; i < count; ++i)
 		{
-			transposed[input_height * i + d] = transformed[input_width * d + i];
+			spectrum.real[index + i] = real[i];
+			spectrum.imag[index + i] = imag[i];
 		}
 	}
-
-	//transform the columns
-	printf("DFT: Transforming columns\n");
-	for(unsigned int d = 0; d < input_width; ++d)
+	else if(spectrum.precision == SPECTRUM_HALF)
 	{
-		unsigned int offset = input_height * d;
-		dft(transposed + offset, input_height, transformed + offset);
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			spectrum.packed_real[index + i] = float_to_half(real[i]);
+			spectrum.packed_imag[index + i] = float_to_half(imag[i]);
+		}
 	}
-
-	//transpose again
-	printf("DFT: Transposing output\n");
-	for(unsigned int d = 0; d < input_width; ++d)
+	else
 	{
-		for(unsigned int i = 0; i < input_height; ++i)
+		float largest = 0.0f;
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			largest = MAX(largest, MAX(fabsf(real[i]), fabsf(imag[i])));
+		}
+		unsigned int blocks_per_row = (spectrum.width + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+		spectrum.scales[blocks_per_row * d + first / TRANSPOSE_BLOCK] = largest / 32767.0f;
+		float inverse = (largest > 0.0f) ? 32767.0f / largest : 0.0f;
+		for(unsigned int i = 0; i < count; ++i)
 		{
-			output[input_width * i + d] = transformed[input_height * d + i];
+			spectrum.packed_real[index + i] = (uint16_t)(int16_t)MIN(32767.0f, MAX(-32767.0f, rintf(real[i] * inverse)));
+			spectrum.packed_imag[index + i] = (uint16_t)(int16_t)MIN(32767.0f, MAX(-32767.0f, rintf(imag[i] * inverse)));
 		}
 	}
-
-	free(transposed);
-	free(transformed);
-	return;
 }
 
-void idft_2d(float complex* input, unsigned int input_height, unsigned int input_width, float complex* output)
+//the inverse of pack_split_segment, any range of one row
+void unpack_split_segment(split_spectrum spectrum, unsigned int d, unsigned int first, unsigned int count, float* real, float* imag)
 {
-	float complex* transformed = (float complex*)malloc(sizeof(float complex) * input_width * input_height);
-
-	//transform the rows
-	printf("IDFT: Transforming rows\n");
-	for(unsigned int d = 0; d < input_height; ++d)
+	unsigned int index = spectrum.width * d + first;
+	if(spectrum.precision == SPECTRUM_FLOAT)
 	{
-		unsigned int offset = input_width * d;
-		idft(input + offset, input_width, transformed + offset);
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			real[i] = spectrum.real[index + i];
+			imag[i] = spectrum.imag[index + i];
+		}
 	}
-
-	//transpose the array
-	printf("IDFT: Transposing array\n");
-	float complex* transposed = (float complex*)malloc(sizeof(float complex) * input_width * input_height);
-	for(unsigned int d = 0; d < input_height; ++d)
+	else if(spectrum.precision == SPECTRUM_HALF)
 	{
-		for(unsigned int i = 0; i < input_width; ++i)
+		for(unsigned int i = 0; i < count; ++i)
 		{
-			transposed[input_height * i + d] = transformed[input_width * d + i];
+			real[i] = half_to_float(spectrum.packed_real[index + i]);
+			imag[i] = half_to_float(spectrum.packed_imag[index + i]);
 		}
 	}
-
-	//transform the columns
-	printf("IDFT: Transforming columns\n");
-	for(unsigned int d = 0; d < input_width; ++d)
+	else
 	{
-		unsigned int offset = input_height * d;
-		idft(transposed + offset, input_height, transformed + offset);
+		unsigned int blocks_per_row = (spectrum.width + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+		for(unsigned int i = 0; i < count; ++i)
+		{
+			float scale = spectrum.scales[blocks_per_row * d + (first + i) / TRANSPOSE_BLOCK];
+			real[i] = (float)(int16_t)spectrum.packed_real[index + i] * scale;
+			imag[i] = (float)(int16_t)spectrum.packed_imag[index + i] * scale;
+		}
 	}
+}
 
-	//transpose again
-	printf("IDFT: Transposing output\n");
-	for(unsigned int d = 0; d < input_width; ++d)
+//copies a complex row into row d of the planes
+void store_split_row(split_spectrum spectrum, unsigned int d, float complex* row)
+{
+	if(spectrum.precision == SPECTRUM_FLOAT)
+	{
+		float* real = spectrum.real + spectrum.width * d;
+		float* imag = spectrum.imag + spectrum.width * d;
+		for(unsigned int i = 0; i < spectrum.width; ++i)
+		{
+			real[i] = crealf(row[i]);
+			imag[i] = cimagf(row[i]);
+		}
+		return;
+	}
+	float real[TRANSPOSE_BLOCK];
+	float imag[TRANSPOSE_BLOCK];
+	for(unsigned int first = 0; first < spectrum.width; first = first + TRANSPOSE_BLOCK)
 	{
-		for(unsigned int i = 0; i < input_height; ++i)
+		unsigned int count = MIN(TRANSPOSE_BLOCK, spectrum.width - first);
+		for(unsigned int i = 0; i < count; ++i)
 		{
-			output[input_width * i + d] = transformed[input_height * d + i];
+			real[i] = crealf(row[first + i]);
+			imag[i] = cimagf(row[first + i]);
 		}
+		pack_split_segment(spectrum, d, first, count, real, imag);
 	}
+}
 
-	free(transposed);
-	free(transformed);
+//input is a half spectrum (see dft_2d), the missing columns are the conjugate mirror and have the same magnitude
+void complex_to_magnitude_image(uint8_t* output, unsigned int height, unsigned int width, split_spectrum input)
+{
+	unsigned int spectrum_width = width / 2 + 1;
+	for(unsigned int d = 0; d < height; ++d)
+	{
+		for(unsigned int i = 0; i < width; ++i)
+		{
+			unsigned int y_index = (d + (height / 2)) % height;
+			unsigned int x_index = (i + (width / 2)) % width;
+			float real, imag;
+			if(i < spectrum_width)
+				unpack_split_segment(input, d, i, 1, &real, &imag);
+			else
+				unpack_split_segment(input, (height - d) % height, width - i, 1, &real, &imag);
+			unsigned int out_index = width * y_index + x_index;
+			float magnitude = 128.0 + 23.0 * log(hypotf(real, imag)/* / (float)(width * height)*/);
+			output[out_index] = (uint8_t)(MIN(255.0, MAX(0.0, (0.5 + magnitude))));
+		}
+	}
 	return;
 }
 
-void resize_dft_image(float complex* input, unsigned int input_height, unsigned int input_width, float complex* output, unsigned int output_height, unsigned int output_width)
+//gathers columns [column, column + columns) into batch, column j of the planes at batch + height * j
+void gather_columns(split_spectrum spectrum, unsigned int column, unsigned int columns, float complex* batch)
 {
-	//find data size to copy
-	unsigned int data_height = (output_height < input_height) ? output_height : input_height;
-	unsigned int data_width = (output_width < input_width) ? output_width : input_width;
-
-	unsigned int y_in;
-	unsigned int y_out;
-	unsigned int x_in;
-	unsigned int x_out;
-
-	//clear output
-	for(unsigned int d = 0; d < (output_width * output_height); ++d)
+	for(unsigned int d = 0; d < spectrum.height; ++d)
 	{
-		output[d] = 0.0;
+		for(unsigned int j = 0; j < columns; ++j)
+		{
+			unsigned int in_index = spectrum.width * d + column + j;
+			batch[spectrum.height * j + d] = spectrum.real[in_index] + I * spectrum.imag[in_index];
+		}
 	}
+}
 
-	for(unsigned int y = 0; y < data_height / 2; ++y)
+//the inverse of gather_columns
+void scatter_columns(split_spectrum spectrum, unsigned int column, unsigned int columns, float complex* batch)
+{
+	for(unsigned int d = 0; d < spectrum.height; ++d)
 	{
-		for(unsigned int x = 0; x < data_width / 2; ++x)
+		for(unsigned int j = 0; j < columns; ++j)
 		{
-			output[output_width * y + x] = input[input_width * y + x];
+			unsigned int out_index = spectrum.width * d + column + j;
+			spectrum.real[out_index] = crealf(batch[spectrum.height * j + d]);
+			spectrum.imag[out_index] = cimagf(batch[spectrum.height * j + d]);
 		}
+	}
+}
 
-		x_in = (data_width / 2) + (input_width - data_width);
-		x_out = (data_width / 2) + (output_width - data_width);
-
-		while(x_in < input_width)
+#ifdef CG3_X86_KERNELS
+//same as gather_columns in steps of 4 columns, unpacking 4 real and 4 imaginary values into 4 complex
+__attribute__((target("sse2")))
+void gather_columns_sse2(split_spectrum spectrum, unsigned int column, unsigned int columns, float complex* batch)
+{
+	unsigned int vector_columns = columns & ~3u;
+	unsigned int height = spectrum.height;
+	for(unsigned int d = 0; d < height; ++d)
+	{
+		const float* real = spectrum.real + spectrum.width * d + column;
+		const float* imag = spectrum.imag + spectrum.width * d + column;
+		unsigned int j = 0;
+		for(; j < vector_columns; j = j + 4)
+		{
+			__m128 re = _mm_loadu_ps(real + j);
+			__m128 im = _mm_loadu_ps(imag + j);
+			__m128 low = _mm_unpacklo_ps(re, im);
+			__m128 high = _mm_unpackhi_ps(re, im);
+			_mm_storel_pi((__m64*)(batch + height * j + d), low);
+			_mm_storeh_pi((__m64*)(batch + height * (j + 1) + d), low);
+			_mm_storel_pi((__m64*)(batch + height * (j + 2) + d), high);
+			_mm_storeh_pi((__m64*)(batch + height * (j + 3) + d), high);
+		}
+		for(; j < columns; ++j)
 		{
-			output[output_width * y + x_out] = input[input_width * y + x_in];
-			++x_in;
-			++x_out;
+			batch[height * j + d] = real[j] + I * imag[j];
 		}
 	}
+}
 
-	y_in = (data_height / 2) + (input_height - data_height);
-	y_out = (data_height / 2) + (output_height - data_height);
-
-	while(y_in < input_height)
+__attribute__((target("sse2")))
+void scatter_columns_sse2(split_spectrum spectrum, unsigned int column, unsigned int columns, float complex* batch)
+{
+	unsigned int vector_columns = columns & ~3u;
+	unsigned int height = spectrum.height;
+	for(unsigned int d = 0; d < height; ++d)
 	{
-		for(unsigned int x = 0; x < data_width / 2; ++x)
+		float* real = spectrum.real + spectrum.width * d + column;
+		float* imag = spectrum.imag + spectrum.width * d + column;
+		unsigned int j = 0;
+		for(; j < vector_columns; j = j + 4)
 		{
-			output[output_width * y_out + x] = input[input_width * y_in + x];
+			__m128 low = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(batch + height * j + d));
+			low = _mm_loadh_pi(low, (const __m64*)(batch + height * (j + 1) + d));
+			__m128 high = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(batch + height * (j + 2) + d));
+			high = _mm_loadh_pi(high, (const __m64*)(batch + height * (j + 3) + d));
+			_mm_storeu_ps(real + j, _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(imag + j, _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
 		}
+		for(; j < columns; ++j)
+		{
+			real[j] = crealf(batch[height * j + d]);
+			imag[j] = cimagf(batch[height * j + d]);
+		}
+	}
+}
+#endif
 
-		x_in = (data_width / 2) + (input_width - data_width);
-		x_out = (data_width / 2) + (output_width - data_width);
-
-		while(x_in < input_width)
+//gather_columns and scatter_columns for packed spectra, a batch is one scale block of each row
+void gather_packed_columns(split_spectrum spectrum, unsigned int column, unsigned int columns, float complex* batch)
+{
+	float real[TRANSPOSE_BLOCK];
+	float imag[TRANSPOSE_BLOCK];
+	for(unsigned int d = 0; d < spectrum.height; ++d)
+	{
+		unpack_split_segment(spectrum, d, column, columns, real, imag);
+		for(unsigned int j = 0; j < columns; ++j)
 		{
-			output[output_width * y_out + x_out] = input[input_width * y_in + x_in];
-			++x_in;
-			++x_out;
+			batch[spectrum.height * j + d] = real[j] + I * imag[j];
 		}
+	}
+}
 
-		++y_in;
-		++y_out;
+void scatter_packed_columns(split_spectrum spectrum, unsigned int column, unsigned int columns, float complex* batch)
+{
+	float real[TRANSPOSE_BLOCK];
+	float imag[TRANSPOSE_BLOCK];
+	for(unsigned int d = 0; d < spectrum.height; ++d)
+	{
+		for(unsigned int j = 0; j < columns; ++j)
+		{
+			real[j] = crealf(batch[spectrum.height * j + d]);
+			imag[j] = cimagf(batch[spectrum.height * j + d]);
+		}
+		pack_split_segment(spectrum, d, column, columns, real, imag);
 	}
+}
 
-	return;
+typedef void (*column_mover)(split_spectrum, unsigned int, unsigned int, float complex*);
+
+void select_column_movers(split_spectrum spectrum, column_mover* gather, column_mover* scatter)
+{
+	*gather = gather_columns;
+	*scatter = scatter_columns;
+	if(spectrum.precision != SPECTRUM_FLOAT)
+	{
+		*gather = gather_packed_columns;
+		*scatter = scatter_packed_columns;
+		return;
+	}
+#ifdef CG3_X86_KERNELS
+	if(__builtin_cpu_supports("sse2"))
+	{
+		*gather = gather_columns_sse2;
+		*scatter = scatter_columns_sse2;
+	}
+#endif
 }
 
-int main(int argc, char** argv)
+//rows per pool chunk, a batch of columns is always one chunk
+#define ROW_CHUNK 16
+
+typedef struct DFT_2D_JOB
 {
-	//Parse program arguments
-	debug_enable = 0;
-	unsigned int arg = 1;
-	if(argc == 1)
+	float* input;
+	unsigned int input_height;
+	unsigned int input_width;
+	split_spectrum output;
+	column_mover gather;
+	column_mover scatter;
+} dft_2d_job;
+
+void dft_2d_rows(void* context, unsigned int first, unsigned int last)
+{
+	dft_2d_job* job = (dft_2d_job*)context;
+	float complex* row = (float complex*)malloc(sizeof(float complex) * job->output.width);
+	for(unsigned int d = first; d < last; ++d)
 	{
-		printf("Usage: -SOURCE <source file> -OUT <output binary> -SCLAED <output scaled image> -MAGNITUDE <output magnitude image> -PREVIEW <output preview image> -DEBUG\n");
-		printf("-SCALED -MAGNITUDE, -PREVIEW and -DEBUG are optional\n");
-		exit(1);
+		real_dft(job->input + job->input_width * d, job->input_width, row);
+		store_split_row(job->output, d, row);
 	}
-	while(arg < (unsigned int)argc)
+	free(row);
+}
+
+void dft_2d_columns(void* context, unsigned int first, unsigned int last)
+{
+	dft_2d_job* job = (dft_2d_job*)context;
+	unsigned int height = job->input_height;
+	float complex* batch = (float complex*)malloc(sizeof(float complex) * height * TRANSPOSE_BLOCK);
+	float complex* column = (float complex*)malloc(sizeof(float complex) * height);
+	for(unsigned int b = first; b < last; ++b)
 	{
-		if(argv[arg][0] == '-')
+		unsigned int d = b * TRANSPOSE_BLOCK;
+		unsigned int columns = MIN(TRANSPOSE_BLOCK, job->output.width - d);
+		job->gather(job->output, d, columns, batch);
+		for(unsigned int j = 0; j < columns; ++j)
 		{
-			to_caps(argv[arg]);
-			if(str_comp_partial(source_string, argv[arg]))
+			float complex* transposed = batch + height * j;
+			dft(transposed, height, column);
+			for(unsigned int i = 0; i < height; ++i)
 			{
-				source_index = ++arg;
+				transposed[i] = column[i];
 			}
-			else if(str_comp_partial(out_string, argv[arg]))
-			{
-				out_index = ++arg;
-			}
-			else if(str_comp_partial(scaled_string, argv[arg]))
-			{
-				scaled_index = ++arg;
-			}
-			else if(str_comp_partial(magnitude_string, argv[arg]))
+		}
+		job->scatter(job->output, d, columns, batch);
+	}
+	free(column);
+	free(batch);
+}
+
+//Output is the half spectrum of the real input: input_height rows of (input_width / 2 + 1) bins,
+//the remaining bins are given by X[-y][-x] = conj(X[y][x]). The column pass works on batches of
+//TRANSPOSE_BLOCK columns in place, so the only other memory is one batch per thread.
+//Rows and column batches are split across the thread pool, each one is computed the same way
+//whichever thread takes it, so the result does not depend on the number of threads.
+void dft_2d(float* input, unsigned int input_height, unsigned int input_width, split_spectrum output)
+{
+	unsigned int spectrum_width = input_width / 2 + 1;
+	dft_2d_job job = {input, input_height, input_width, output, NULL, NULL};
+	select_column_movers(output, &job.gather, &job.scatter);
+
+	//transform the rows
+	printf("DFT: Transforming rows\n");
+	pool_run(dft_2d_rows, &job, input_height, ROW_CHUNK);
+
+	//transform the columns
+	printf("DFT: Transforming columns\n");
+	pool_run(dft_2d_columns, &job, (spectrum_width + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK, 1);
+	return;
+}
+
+//maps an output frequency index to the input frequency it is copied from, -1 if it is left at zero
+//keeps the lowest data_size / 2 positive and data_size - data_size / 2 negative frequencies
+int resize_dft_index(unsigned int out_index, unsigned int input_size, unsigned int output_size)
+{
+	unsigned int data_size = (output_size < input_size) ? output_size : input_size;
+	if(out_index < data_size / 2)
+		return out_index;
+	if(out_index >= (data_size / 2) + (output_size - data_size))
+		return out_index + input_size - output_size;
+	return -1;
+}
+
+//1D crop of a full spectrum
+void resize_dft(float complex* input, unsigned int input_size, float complex* output, unsigned int output_size)
+{
+	for(unsigned int d = 0; d < output_size; ++d)
+	{
+		int in_index = resize_dft_index(d, input_size, output_size);
+		output[d] = (in_index < 0) ? 0.0 : input[in_index];
+	}
+}
+
+//1D crop of the half spectrum of a real sequence, the output is a full spectrum
+void resize_real_dft(float complex* input, unsigned int input_size, float complex* output, unsigned int output_size)
+{
+	for(unsigned int d = 0; d < output_size; ++d)
+	{
+		int in_index = resize_dft_index(d, input_size, output_size);
+		if(in_index < 0)
+			output[d] = 0.0;
+		else if((unsigned int)in_index <= input_size / 2)
+			output[d] = input[in_index];
+		else
+			output[d] = conjf(input[input_size - in_index]);
+	}
+}
+
+typedef struct RESAMPLE_JOB
+{
+	float* input;
+	unsigned int input_height;
+	unsigned int input_width;
+	float* output;
+	unsigned int output_height;
+	unsigned int output_width;
+	const float complex* row_gain;	//NULL or one factor per cropped bin of each axis
+	const float complex* column_gain;
+	split_spectrum narrowed;
+	column_mover gather;
+	column_mover scatter;
+} resample_job;
+
+//complex multiply without the C99 Annex G NaN/Inf recovery (__mulsc3), as in fft.c
+static inline float complex cmul(float complex a, float complex b)
+{
+	float ar = crealf(a);
+	float ai = cimagf(a);
+	float br = crealf(b);
+	float bi = cimagf(b);
+	return (ar * br - ai * bi) + I * (ar * bi + ai * br);
+}
+
+//transforms rows and brings them to the output width
+void resample_rows(void* context, unsigned int first, unsigned int last)
+{
+	resample_job* job = (resample_job*)context;
+	unsigned int max_size = MAX(job->input_width, job->output_width);
+	float complex* spectrum = (float complex*)malloc(sizeof(float complex) * max_size);
+	float complex* cropped = (float complex*)malloc(sizeof(float complex) * max_size);
+	for(unsigned int d = first; d < last; ++d)
+	{
+		real_dft(job->input + job->input_width * d, job->input_width, spectrum);
+		resize_real_dft(spectrum, job->input_width, cropped, job->output_width);
+		if(job->row_gain)
+		{
+			for(unsigned int i = 0; i < job->output_width; ++i)
+				cropped[i] = cmul(cropped[i], job->row_gain[i]);
+		}
+		idft(cropped, job->output_width, spectrum);
+		store_split_row(job->narrowed, d, spectrum);
+	}
+	free(cropped);
+	free(spectrum);
+}
+
+//transforms batches of narrowed columns and brings them to the output height
+void resample_columns(void* context, unsigned int first, unsigned int last)
+{
+	resample_job* job = (resample_job*)context;
+	unsigned int input_height = job->input_height;
+	unsigned int max_size = MAX(input_height, job->output_height);
+	float complex* spectrum = (float complex*)malloc(sizeof(float complex) * max_size);
+	float complex* cropped = (float complex*)malloc(sizeof(float complex) * max_size);
+	float complex* batch = (float complex*)malloc(sizeof(float complex) * input_height * TRANSPOSE_BLOCK);
+	for(unsigned int b = first; b < last; ++b)
+	{
+		unsigned int d = b * TRANSPOSE_BLOCK;
+		unsigned int columns = MIN(TRANSPOSE_BLOCK, job->output_width - d);
+		job->gather(job->narrowed, d, columns, batch);
+		for(unsigned int j = 0; j < columns; ++j)
+		{
+			dft(batch + input_height * j, input_height, spectrum);
+			resize_dft(spectrum, input_height, cropped, job->output_height);
+			if(job->column_gain)
 			{
-				magnitude_index = ++arg;
+				for(unsigned int i = 0; i < job->output_height; ++i)
+					cropped[i] = cmul(cropped[i], job->column_gain[i]);
 			}
-			else if(str_comp_partial(preview_string, argv[arg]))
+			idft(cropped, job->output_height, spectrum);
+			for(unsigned int i = 0; i < job->output_height; ++i)
 			{
-				preview_index = ++arg;
+				job->output[job->output_width * i + d + j] = crealf(spectrum[i]);
 			}
-			else if(str_comp_partial(debug_string, argv[arg]))
+		}
+	}
+	free(batch);
+	free(cropped);
+	free(spectrum);
+}
+
+//Spectral resize done one axis at a time. Transform, crop and inverse transform are all linear and
+//separable, so the real part of this equals the real part of idft_2d(resize(dft_2d(input))), but the
+//column pass only sees output_width columns and no full resolution 2D spectrum is ever stored.
+//row_gain and column_gain (may be NULL) multiply the cropped bins, see resample_predecimated().
+void resample_dft(float* input, unsigned int input_height, unsigned int input_width, float* output, unsigned int output_height, unsigned int output_width, const float complex* row_gain, const float complex* column_gain)
+{
+	resample_job job = {input, input_height, input_width, output, output_height, output_width, row_gain, column_gain};
+	create_split_spectrum(&job.narrowed, input_height, output_width, SPECTRUM_FLOAT);
+	select_column_movers(job.narrowed, &job.gather, &job.scatter);
+
+	printf("Resample: Transforming rows\n");
+	pool_run(resample_rows, &job, input_height, ROW_CHUNK);
+
+	printf("Resample: Transforming columns\n");
+	pool_run(resample_columns, &job, (output_width + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK, 1);
+
+	free_split_spectrum(&job.narrowed);
+	return;
+}
+
+//Spatial resampling, an O(pixels) alternative to resample_dft selected with -RESAMPLE.
+//A filter's support is its radius in output pixels, when shrinking it is stretched by the ratio
+//so that every input pixel contributes. kernel is NULL for the box filter, which weights each
+//input pixel by how much of it the output pixel covers.
+typedef struct RESAMPLE_FILTER
+{
+	const char* name;
+	float support;
+	float (*kernel)(float x);
+} resample_filter;
+
+float bilinear_kernel(float x)
+{
+	x = fabsf(x);
+	return (x < 1.0f) ? 1.0f - x : 0.0f;
+}
+
+//Keys' cubic convolution with a = -0.5
+float bicubic_kernel(float x)
+{
+	x = fabsf(x);
+	if(x < 1.0f)
+		return (1.5f * x - 2.5f) * x * x + 1.0f;
+	if(x < 2.0f)
+		return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+	return 0.0f;
+}
+
+float lanczos3_kernel(float x)
+{
+	x = fabsf(x);
+	if(x == 0.0f)
+		return 1.0f;
+	if(x >= 3.0f)
+		return 0.0f;
+	float pi_x = PI * x;
+	return 3.0f * sinf(pi_x) * sinf(pi_x / 3.0f) / (pi_x * pi_x);
+}
+
+//indexed by the RESAMPLE_ values, DFT is resample_dft
+#define RESAMPLE_DFT 0
+#define RESAMPLE_BOX 1
+#define RESAMPLE_BILINEAR 2
+#define RESAMPLE_BICUBIC 3
+#define RESAMPLE_LANCZOS3 4
+#define NUM_RESAMPLE_FILTERS 5
+
+const resample_filter resample_filters[NUM_RESAMPLE_FILTERS] =
+{
+	{"DFT", 0.0f, NULL},
+	{"BOX", 0.5f, NULL},
+	{"BILINEAR", 1.0f, bilinear_kernel},
+	{"BICUBIC", 2.0f, bicubic_kernel},
+	{"LANCZOS3", 3.0f, lanczos3_kernel}
+};
+
+//output d of one axis is the sum of weights[taps * d + t] * input[first[d] + t] for t < count[d],
+//the weights of each output sum to 1
+typedef struct RESAMPLE_WEIGHTS
+{
+	unsigned int* first;
+	unsigned int* count;
+	float* weights;
+	unsigned int taps;
+} resample_weights;
+
+void create_resample_weights(resample_weights* table, const resample_filter* filter, unsigned int input_size, unsigned int output_size)
+{
+	float ratio = (float)input_size / (float)output_size;
+	float scale = MAX(1.0f, ratio);
+	float radius = filter->support * scale;
+	table->taps = (unsigned int)ceilf(2.0f * radius) + 3;
+	table->first = (unsigned int*)malloc(sizeof(unsigned int) * output_size);
+	table->count = (unsigned int*)malloc(sizeof(unsigned int) * output_size);
+	table->weights = (float*)malloc(sizeof(float) * table->taps * output_size);
+	for(unsigned int d = 0; d < output_size; ++d)
+	{
+		//pixel centers are at integer positions, so output d sits at (d + 0.5) * ratio - 0.5
+		float center = ((float)d + 0.5f) * ratio - 0.5f;
+		int low = MAX(0, (int)floorf(center - radius));
+		int high = MIN((int)input_size - 1, (int)ceilf(center + radius));
+		float* weights = table->weights + table->taps * d;
+		unsigned int count = 0;
+		float sum = 0.0f;
+		table->first[d] = low;
+		for(int i = low; i <= high; ++i)
+		{
+			float weight;
+			if(filter->kernel)
+				weight = filter->kernel(((float)i - center) / scale);
+			else
+				weight = MAX(0.0f, MIN(i + 0.5f, center + 0.5f * scale) - MAX(i - 0.5f, center - 0.5f * scale));
+			if(count == 0 && weight == 0.0f)
 			{
-				debug_enable = 0xFF;
+				table->first[d] = i + 1;
+				continue;
 			}
-			++arg;
+			weights[count++] = weight;
+			sum = sum + weight;
 		}
-		else
+		while(count && weights[count - 1] == 0.0f)
+			--count;
+		if(sum == 0.0f)	//nothing in reach, use the nearest pixel
 		{
-			source_index = arg++;
+			table->first[d] = MIN(input_size - 1, (unsigned int)MAX(0.0f, center + 0.5f));
+			weights[0] = 1.0f;
+			count = 1;
+			sum = 1.0f;
 		}
+		for(unsigned int t = 0; t < count; ++t)
+		{
+			weights[t] = weights[t] / sum;
+		}
+		table->count[d] = count;
 	}
-	if(arg > (unsigned int)argc)
+}
+
+void free_resample_weights(resample_weights* table)
+{
+	free(table->first);
+	free(table->count);
+	free(table->weights);
+}
+
+//sum[i] += weight * row[i], the vertical filter taps
+typedef void (*row_accumulator)(float* sum, const float* row, float weight, unsigned int count);
+
+void accumulate_row(float* sum, const float* row, float weight, unsigned int count)
+{
+	for(unsigned int i = 0; i < count; ++i)
 	{
-		printf("Invalid arguments!\n");
-		exit(1);
+		sum[i] = sum[i] + weight * row[i];
 	}
-	if(source_index == 0)
+}
+
+#ifdef CG3_X86_KERNELS
+//same multiplies and adds as accumulate_row, so every version gives the same sums
+__attribute__((target("sse2")))
+void accumulate_row_sse2(float* sum, const float* row, float weight, unsigned int count)
+{
+	__m128 w = _mm_set1_ps(weight);
+	unsigned int i = 0;
+	for(; i + 4 <= count; i = i + 4)
 	{
-		printf("No source file specified!\n");
-		exit(1);
+		_mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), _mm_mul_ps(w, _mm_loadu_ps(row + i))));
 	}
-	if(out_index == 0)
+	for(; i < count; ++i)
 	{
-		printf("No output file specified!\n");
-		exit(1);
+		sum[i] = sum[i] + weight * row[i];
 	}
+}
 
-	unsigned char* image;
-	unsigned int width, height;
-
-	unsigned error = lodepng_decode32_file(&image, &width, &height, argv[source_index]);
-	if(error)
+__attribute__((target("avx2")))
+void accumulate_row_avx2(float* sum, const float* row, float weight, unsigned int count)
+{
+	__m256 w = _mm256_set1_ps(weight);
+	unsigned int i = 0;
+	for(; i + 8 <= count; i = i + 8)
 	{
-		printf("error %u: %s\n", error, lodepng_error_text(error));
-		return 1;
+		_mm256_storeu_ps(sum + i, _mm256_add_ps(_mm256_loadu_ps(sum + i), _mm256_mul_ps(w, _mm256_loadu_ps(row + i))));
 	}
-	printf("Loaded image\n");
-	printf("Width is: %u\n", width);
-	printf("Height is: %u\n", height);
-	printf("Image red channel at 0: %u\n", image[0]);
-	printf("Image green channel at 0: %u\n", image[1]);
-	printf("Image blue channel at 0: %u\n", image[2]);
-	printf("Image alpha channel at 0: %d\n", image[3]);
-
-	uint8_t* input_red;
-	uint8_t* input_green;
-	uint8_t* input_blue;
-
-	input_red = (uint8_t*)malloc(sizeof(uint8_t) * width * height);
-	input_green = (uint8_t*)malloc(sizeof(uint8_t) * width * height);
-	input_blue = (uint8_t*)malloc(sizeof(uint8_t) * width * height);
-
-	split_image((uint8_t*)image, height, width, input_red, input_green, input_blue, NULL);
-	free(image);
-
-	float complex* cplx_source_red;
-	float complex* cplx_source_green;
-	float complex* cplx_source_blue;
-
-	cplx_source_red = (float complex*)malloc(sizeof(float complex) * width * height);
-	cplx_source_green = (float complex*)malloc(sizeof(float complex) * width * height);
-	cplx_source_blue = (float complex*)malloc(sizeof(float complex) * width * height);
-	printf("Created complex image\n");
-
-	image_to_complex(input_red, height, width, cplx_source_red, height, width);
-	image_to_complex(input_green, height, width, cplx_source_green, height, width);
-	image_to_complex(input_blue, height, width, cplx_source_blue, height, width);
-	free(input_red);
-	free(input_green);
-	free(input_blue);
-	printf("Copied data to complex image\n");
-
-	float complex* dft_red;
-	float complex* dft_green;
-	float complex* dft_blue;
-
-	dft_red = (float complex*)malloc(sizeof(float complex) * width * height);
-	dft_green = (float complex*)malloc(sizeof(float complex) * width * height);
-	dft_blue = (float complex*)malloc(sizeof(float complex) * width * height);
-	printf("Created blank DFT image\n");
-
-	dft_2d(cplx_source_red, height, width, dft_red);
-	dft_2d(cplx_source_green, height, width, dft_green);
-	dft_2d(cplx_source_blue, height, width, dft_blue);
-	free(cplx_source_red);
-	free(cplx_source_green);
-	free(cplx_source_blue);
-	printf("Filled DFT image\n");
+	for(; i < count; ++i)
+	{
+		sum[i] = sum[i] + weight * row[i];
+	}
+}
+#endif
 
-	if(magnitude_index)
+row_accumulator select_row_accumulator(void)
+{
+#ifdef CG3_X86_KERNELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+		return accumulate_row_avx2;
+	if(__builtin_cpu_supports("sse2"))
+		return accumulate_row_sse2;
+#endif
+	return accumulate_row;
+}
+
+typedef struct SPATIAL_JOB
+{
+	float* input;
+	unsigned int input_width;
+	float* output;
+	unsigned int output_width;
+	resample_weights rows;
+	resample_weights columns;
+	row_accumulator accumulate;
+} spatial_job;
+
+//filters output rows first to last - 1: the vertical taps over whole input rows into one
+//input_width row, then the horizontal taps along it
+void resample_spatial_rows(void* context, unsigned int first, unsigned int last)
+{
+	spatial_job* job = (spatial_job*)context;
+	float* row = (float*)malloc(sizeof(float) * job->input_width);
+	for(unsigned int d = first; d < last; ++d)
 	{
-		uint8_t* magnitude_red;
-		uint8_t* magnitude_green;
-		uint8_t* magnitude_blue;
+		const float* weights = job->rows.weights + job->rows.taps * d;
+		for(unsigned int i = 0; i < job->input_width; ++i)
+		{
+			row[i] = 0.0f;
+		}
+		for(unsigned int t = 0; t < job->rows.count[d]; ++t)
+		{
+			job->accumulate(row, job->input + job->input_width * (job->rows.first[d] + t), weights[t], job->input_width);
+		}
+		for(unsigned int i = 0; i < job->output_width; ++i)
+		{
+			const float* source = row + job->columns.first[i];
+			weights = job->columns.weights + job->columns.taps * i;
+			float sum = 0.0f;
+			for(unsigned int t = 0; t < job->columns.count[i]; ++t)
+			{
+				sum = sum + weights[t] * source[t];
+			}
+			job->output[job->output_width * d + i] = sum;
+		}
+	}
+	free(row);
+}
+
+//Separable spatial resize with one of the resample_filters, each output row is a pool task.
+void resample_spatial(const resample_filter* filter, float* input, unsigned int input_height, unsigned int input_width, float* output, unsigned int output_height, unsigned int output_width)
+{
+	spatial_job job = {input, input_width, output, output_width};
+	create_resample_weights(&job.rows, filter, input_height, output_height);
+	create_resample_weights(&job.columns, filter, input_width, output_width);
+	job.accumulate = select_row_accumulator();
 
-		magnitude_red = (uint8_t*)malloc(sizeof(uint8_t) * width * height);
-		magnitude_green = (uint8_t*)malloc(sizeof(uint8_t) * width * height);
-		magnitude_blue = (uint8_t*)malloc(sizeof(uint8_t) * width * height);
+	printf("Resample: Filtering with %s\n", filter->name);
+	pool_run(resample_spatial_rows, &job, output_height, 1);
 
-		complex_to_magnitude_image(magnitude_red, height, width, dft_red);
-		complex_to_magnitude_image(magnitude_green, height, width, dft_green);
-		complex_to_magnitude_image(magnitude_blue, height, width, dft_blue);
-		printf("Created magnitude plot\n");
+	free_resample_weights(&job.rows);
+	free_resample_weights(&job.columns);
+}
 
-		uint8_t* magnitude_image;
-		magnitude_image = (uint8_t*)malloc(sizeof(uint8_t) * height * width * 4);
+//cubic B-spline, its spectrum is sinc^4 so that every sidelobe is far down
+float bspline_kernel(float x)
+{
+	x = fabsf(x);
+	if(x < 1.0f)
+		return (4.0f + (3.0f * x - 6.0f) * x * x) / 6.0f;
+	if(x < 2.0f)
+		return (2.0f - x) * (2.0f - x) * (2.0f - x) / 6.0f;
+	return 0.0f;
+}
 
-		merge_image(magnitude_image, height, width, magnitude_red, magnitude_green, magnitude_blue, NULL);
-		free(magnitude_red);
-		free(magnitude_green);
-		free(magnitude_blue);
-		printf("Converted magnitude plot to RGBA\n");
+const resample_filter predecimate_filter = {"B-SPLINE", 2.0f, bspline_kernel};
 
-		//TODO: enforce PNG file extension
-		error = lodepng_encode32_file(argv[magnitude_index], magnitude_image, width, height);
-		if(error)
+//-DECIMATE keeps factor times the target, and only shrinks axes that are at least twice that
+unsigned int predecimate_size(unsigned int source_size, unsigned int target_size, unsigned int factor)
+{
+	return (source_size >= 2 * factor * target_size) ? factor * target_size : source_size;
+}
+
+//Gains for the bins resample_dft keeps when cropping a B-spline shrunk line of decimated_size
+//samples to output_size. Bin k (cycles per line) was scaled by sinc(k / decimated_size)^4, which
+//is divided back out, and pixel p of the shrunk line sits at (p + 0.5) * scale - 0.5 in the source
+//instead of p * scale where the crop expects it, which the phase term moves back.
+void create_predecimate_gain(float complex* gain, unsigned int source_size, unsigned int decimated_size, unsigned int output_size)
+{
+	double scale = (double)source_size / (double)decimated_size;
+	double shift = 0.5 * (1.0 - 1.0 / scale);	//in shrunk pixels
+	for(unsigned int d = 0; d < output_size; ++d)
+	{
+		int k = (d < output_size / 2) ? (int)d : (int)d - (int)output_size;
+		double x = (double)k / (double)decimated_size;
+		double sinc = (k == 0) ? 1.0 : sin(PI * x) / (PI * x);
+		gain[d] = (float complex)(cexp(-2.0 * PI * I * k * shift / (double)decimated_size) / (sinc * sinc * sinc * sinc));
+	}
+}
+
+//Spatial B-spline shrink to factor times the output size, then the DFT resize of that with the
+//filter's passband droop and shift taken back out, so the transforms cost in proportion to the
+//output size instead of the source. Returns 0 without doing anything if the source is too small
+//for it to pay off.
+int resample_predecimated(float* input, unsigned int input_height, unsigned int input_width, float* output, unsigned int output_height, unsigned int output_width, unsigned int factor)
+{
+	unsigned int height = predecimate_size(input_height, output_height, factor);
+	unsigned int width = predecimate_size(input_width, output_width, factor);
+	if(height == input_height || width == input_width)
+		return 0;
+	printf("Decimate: %ux%u to %ux%u\n", input_width, input_height, width, height);
+	float* decimated = (float*)malloc(sizeof(float) * width * height);
+	resample_spatial(&predecimate_filter, input, input_height, input_width, decimated, height, width);
+
+	float complex* row_gain = (float complex*)malloc(sizeof(float complex) * output_width);
+	float complex* column_gain = (float complex*)malloc(sizeof(float complex) * output_height);
+	create_predecimate_gain(row_gain, input_width, width, output_width);
+	create_predecimate_gain(column_gain, input_height, height, output_height);
+	resample_dft(decimated, height, width, output, output_height, output_width, row_gain, column_gain);
+	free(column_gain);
+	free(row_gain);
+	free(decimated);
+	return 1;
+}
+
+//the resampler selected with -RESAMPLE, a copy when the size does not change
+void resample_image(float* input, unsigned int input_height, unsigned int input_width, float* output, unsigned int output_height, unsigned int output_width)
+{
+	if(input_height == output_height && input_width == output_width)
+	{
+		printf("Resample: Same size, copying\n");
+		for(unsigned int i = 0; i < output_height * output_width; ++i)
 		{
-			printf("error %u: %s\n", error, lodepng_error_text(error));
-			return 1;
+			output[i] = input[i];
 		}
-		printf("Wrote magnitude image\n");
-		free(magnitude_image);
 	}
+	else if(resample_index == RESAMPLE_DFT)
+		resample_dft(input, input_height, input_width, output, output_height, output_width, NULL, NULL);
+	else
+		resample_spatial(&resample_filters[resample_index], input, input_height, input_width, output, output_height, output_width);
+}
 
-	float complex* resized_dft_red;
-	float complex* resized_dft_green;
-	float complex* resized_dft_blue;
+//Everything the conversion tasks share. Each task only touches its own channel's buffers or
+//buffers whose producers it depends on.
+typedef struct CONVERSION
+{
+	char** argv;
+	unsigned int width;
+	unsigned int height;
+	float* real_planes[3];	//decoded source, one plane per color channel
+	uint8_t* magnitude_planes[3];
+	float* ift_planes[3];	//256x192, only with -SCALED
+	float* element_planes[3];	//128x96
+	uint8_t cg3_image[3072];
+	unsigned int error;	//set by an output that could not be written
+} conversion;
 
-	unsigned int new_height = 192;
-	unsigned int new_width = 256;
+#define SCALED_HEIGHT 192
+#define SCALED_WIDTH 256
+//CG3 is a 128x96 mode, the quantizer works on that grid directly
+#define ELEMENT_HEIGHT 96
+#define ELEMENT_WIDTH 128
 
-	resized_dft_red = (float complex*)malloc(sizeof(float complex) * new_width * new_height);
-	resized_dft_green = (float complex*)malloc(sizeof(float complex) * new_width * new_height);
-	resized_dft_blue = (float complex*)malloc(sizeof(float complex) * new_width * new_height);
-	printf("Created new DFT image\n");
+void magnitude_channel_task(void* context, unsigned int channel)
+{
+	conversion* conv = (conversion*)context;
+	split_spectrum spectrum;
+	create_split_spectrum(&spectrum, conv->height, conv->width / 2 + 1, spectrum_precision);
+	dft_2d(conv->real_planes[channel], conv->height, conv->width, spectrum);
+	conv->magnitude_planes[channel] = (uint8_t*)malloc(sizeof(uint8_t) * conv->width * conv->height);
+	complex_to_magnitude_image(conv->magnitude_planes[channel], conv->height, conv->width, spectrum);
+	free_split_spectrum(&spectrum);
+	printf("Created magnitude plot of channel %u\n", channel);
+}
 
-	resize_dft_image(dft_red, height, width, resized_dft_red, new_height, new_width);
-	resize_dft_image(dft_green, height, width, resized_dft_green, new_height, new_width);
-	resize_dft_image(dft_blue, height, width, resized_dft_blue, new_height, new_width);
-	free(dft_red);
-	free(dft_green);
-	free(dft_blue);
-	printf("Resized DFT image\n");
+//resample_image with the -DECIMATE shortcut in front of it when that is selected and pays off
+void resample_source(float* input, unsigned int input_height, unsigned int input_width, float* output, unsigned int output_height, unsigned int output_width)
+{
+	if(!(decimate_factor && resample_index == RESAMPLE_DFT && resample_predecimated(input, input_height, input_width, output, output_height, output_width, decimate_factor)))
+		resample_image(input, input_height, input_width, output, output_height, output_width);
+}
 
-	float complex* ift_red;
-	float complex* ift_green;
-	float complex* ift_blue;
+void resample_channel_task(void* context, unsigned int channel)
+{
+	conversion* conv = (conversion*)context;
+	float* real = conv->real_planes[channel];
+	unsigned int height = conv->height;
+	unsigned int width = conv->width;
+	conv->element_planes[channel] = (float*)malloc(sizeof(float) * ELEMENT_WIDTH * ELEMENT_HEIGHT);
+	if(scaled_index)
+	{
+		conv->ift_planes[channel] = (float*)malloc(sizeof(float) * SCALED_WIDTH * SCALED_HEIGHT);
+		resample_source(real, height, width, conv->ift_planes[channel], SCALED_HEIGHT, SCALED_WIDTH);
+	}
+	if(scaled_index && !(decimate_factor && resample_index == RESAMPLE_DFT))
+	{
+		//the element grid keeps a subset of the scaled image's bins, so cropping again from the scaled
+		//(unrounded) image gives the same result as cropping from the source. The spatial filters
+		//only approximate that, but halving the small scaled image is much cheaper than the source.
+		resample_image(conv->ift_planes[channel], SCALED_HEIGHT, SCALED_WIDTH, conv->element_planes[channel], ELEMENT_HEIGHT, ELEMENT_WIDTH);
+	}
+	else
+	{
+		//-DECIMATE shrinks to factor times the target it is given, so the elements are always made
+		//from the source to keep the .cg3 the same with and without -SCALED
+		resample_source(real, height, width, conv->element_planes[channel], ELEMENT_HEIGHT, ELEMENT_WIDTH);
+	}
+	printf("Resampled channel %u\n", channel);
+}
 
-	ift_red = (float complex*)malloc(sizeof(float complex) * new_width * new_height);
-	ift_green = (float complex*)malloc(sizeof(float complex) * new_width * new_height);
-	ift_blue = (float complex*)malloc(sizeof(float complex) * new_width * new_height);
-	printf("Created IFT image\n");
+//runs once the magnitude and resample tasks of the channel are done with its real image
+void release_channel_task(void* context, unsigned int channel)
+{
+	conversion* conv = (conversion*)context;
+	free(conv->real_planes[channel]);
+}
 
-	idft_2d(resized_dft_red, new_height, new_width, ift_red);
-	idft_2d(resized_dft_green, new_height, new_width, ift_green);
-	idft_2d(resized_dft_blue, new_height, new_width, ift_blue);
-	free(resized_dft_red);
-	free(resized_dft_green);
-	free(resized_dft_blue);
-	printf("Filled IFT image\n");
+void write_magnitude_task(void* context, unsigned int argument)
+{
+	conversion* conv = (conversion*)context;
+	unsigned int width = conv->width;
+	unsigned int height = conv->height;
+	uint8_t* magnitude_image;
+	magnitude_image = (uint8_t*)malloc(sizeof(uint8_t) * height * width * 4);
+
+	merge_image(magnitude_image, height, width, conv->magnitude_planes[0], conv->magnitude_planes[1], conv->magnitude_planes[2], NULL);
+	for(unsigned int c = 0; c < 3; ++c)
+	{
+		free(conv->magnitude_planes[c]);
+	}
+	printf("Converted magnitude plot to RGBA\n");
 
-	uint8_t* output_red;
-	uint8_t* output_green;
-	uint8_t* output_blue;
+	//TODO: enforce PNG file extension
+	unsigned error = lodepng_encode32_file(conv->argv[magnitude_index], magnitude_image, width, height);
+	free(magnitude_image);
+	if(error)
+	{
+		printf("error %u: %s\n", error, lodepng_error_text(error));
+		conv->error = error;
+		return;
+	}
+	printf("Wrote magnitude image\n");
+}
 
+void write_scaled_task(void* context, unsigned int argument)
+{
+	conversion* conv = (conversion*)context;
 	//create scaled RGB image
 	pixel_image scaled_image;
-	create_pixel_image(&scaled_image, new_height, new_width);
-	printf("Created new RGB image\n");
-
-	complex_to_pixel_image(scaled_image, ift_red, ift_green, ift_blue);
-	free(ift_red);
-	free(ift_green);
-	free(ift_blue);
+	create_pixel_image(&scaled_image, SCALED_HEIGHT, SCALED_WIDTH);
+	real_to_pixel_image(scaled_image, conv->ift_planes[0], conv->ift_planes[1], conv->ift_planes[2]);
+	for(unsigned int c = 0; c < 3; ++c)
+	{
+		free(conv->ift_planes[c]);
+	}
 	printf("Filled in new RGB image\n");
 
+	//convert RGB image to RGBA image
+	unsigned int image_size = 4 * scaled_image.height * scaled_image.width;
+	unsigned char* output_image = (unsigned char*)malloc(image_size * sizeof(unsigned char));
+	fill_RGBA_image(output_image, &scaled_image);
+	delete_pixel_image(&scaled_image);
+	printf("Converted RGB image to RGBA\n");
+
+	//Write scaled image to file
+	//TODO: enforce PNG file extension
+	unsigned error = lodepng_encode32_file(conv->argv[scaled_index], output_image, SCALED_WIDTH, SCALED_HEIGHT);
+	free(output_image);
+	if(error)
+	{
+		printf("error %u: %s\n", error, lodepng_error_text(error));
+		conv->error = error;
+		return;
+	}
+	printf("Wrote scaled image\n");
+}
+
+void quantize_task(void* context, unsigned int argument)
+{
+	conversion* conv = (conversion*)context;
+	pixel_image element_image;
+	create_pixel_image(&element_image, ELEMENT_HEIGHT, ELEMENT_WIDTH);
+	real_to_pixel_image(element_image, conv->element_planes[0], conv->element_planes[1], conv->element_planes[2]);
+	for(unsigned int c = 0; c < 3; ++c)
+	{
+		free(conv->element_planes[c]);
+	}
+	printf("Filled in element image\n");
+
 	//create cg3 elements
-	cg3_element cg3_display_elements[12288];
-	create_cg3_elements(cg3_display_elements, &scaled_image);
-	cg3_heapsort(cg3_display_elements, 12288);
+	cg3_moments* cg3_element_moments = (cg3_moments*)malloc(sizeof(cg3_moments));
+	create_cg3_moments(cg3_element_moments, &element_image);
+	delete_pixel_image(&element_image);
+	cg3_elements* cg3_display_elements = (cg3_elements*)malloc(sizeof(cg3_elements));
+	create_cg3_elements(cg3_display_elements, cg3_element_moments);
+	free(cg3_element_moments);
+	cg3_sort(cg3_display_elements);
 	printf("Created and sorted display elements\n");
 
 	printf("Top 25 RMS errors:\n");
 	for(unsigned int d = 0; d < 25; ++d)
 	{
-		printf("%u\n", cg3_display_elements[d].min_rms_error);
+		printf("%u\n", cg3_min_rms_error(cg3_display_elements, cg3_display_elements->order[d]));
 	}
 
 	//create cg3 image
-	uint8_t cg3_image[3072];
-	create_cg3_output(cg3_image, cg3_display_elements, &scaled_image);
+	create_cg3_output(conv->cg3_image, cg3_display_elements);
+	free(cg3_display_elements);
 	printf("Created CG3 image\n");
+}
 
-	//write cg3 image
+void write_cg3_task(void* context, unsigned int argument)
+{
+	conversion* conv = (conversion*)context;
 	char new_name[32];
-	replace_file_extension(cg3_string, argv[out_index], new_name);
+	replace_file_extension(cg3_string, conv->argv[out_index], new_name);
 	size_t written = 0;
 	FILE* f = fopen(new_name, "wb");
 	while (written < 3072)
 	{
-		written += fwrite(cg3_image + written, sizeof(uint8_t), 3072 - written, f);
+		written += fwrite(conv->cg3_image + written, sizeof(uint8_t), 3072 - written, f);
 		if (written == 0) {
 		    printf("Error writing output file!\n");
 		}
 	}
 	fclose(f);
 	printf("Wrote CG3 image\n");
+}
 
-	unsigned int image_size;
-	if(preview_index)
+void write_preview_task(void* context, unsigned int argument)
+{
+	conversion* conv = (conversion*)context;
+	//create cg3 preview
+	unsigned int image_size = 4 * 192 * 256;
+	unsigned char* rgba_cg3_preview = (unsigned char*)malloc(image_size * sizeof(unsigned char));
+	cg3_to_rgba(rgba_cg3_preview, conv->cg3_image);
+	printf("Created CG3 preview\n");
+	//TODO: enforce PNG file extension
+	unsigned error = lodepng_encode32_file(conv->argv[preview_index], rgba_cg3_preview, 256, 192);
+	free(rgba_cg3_preview);
+	if(error)
 	{
-		//create cg3 preview
-		image_size = 4 * 192 * 256;
-		unsigned char* rgba_cg3_preview = (unsigned char*)malloc(image_size * sizeof(unsigned char));
-		cg3_to_rgba(rgba_cg3_preview, cg3_image);
-		printf("Created CG3 preview\n");
-		//TODO: enforce PNG file extension
-		error = lodepng_encode32_file(argv[preview_index], rgba_cg3_preview, 256, 192);
-		if(error)
-		{
-			printf("error %u: %s\n", error, lodepng_error_text(error));
-			return 1;
-		}
-		free(rgba_cg3_preview);
-		printf("Wrote CG3 preview\n");
+		printf("error %u: %s\n", error, lodepng_error_text(error));
+		conv->error = error;
+		return;
 	}
+	printf("Wrote CG3 preview\n");
+}
 
+//(magnitude, resample) -> release per channel, quantize once all three channels are resampled,
+//and the outputs as soon as what they write exists. Added in dependency order with the channels one
+//after another, so a single thread keeps only one channel's spectrum alive and frees each channel's
+//source as soon as it is done, while more threads run the channels and the outputs side by side.
+void add_conversion_tasks(task_graph* graph)
+{
+	unsigned int magnitude_tasks[3];
+	unsigned int resample_tasks[3];
+	for(unsigned int c = 0; c < 3; ++c)
+	{
+		if(magnitude_index)
+			magnitude_tasks[c] = graph_add(graph, magnitude_channel_task, c);
+		resample_tasks[c] = graph_add(graph, resample_channel_task, c);
+		unsigned int release = graph_add(graph, release_channel_task, c);
+		graph_depend(graph, release, resample_tasks[c]);
+		if(magnitude_index)
+			graph_depend(graph, release, magnitude_tasks[c]);
+	}
+	if(magnitude_index)
+	{
+		unsigned int write_magnitude = graph_add(graph, write_magnitude_task, 0);
+		for(unsigned int c = 0; c < 3; ++c)
+			graph_depend(graph, write_magnitude, magnitude_tasks[c]);
+	}
+	unsigned int quantize = graph_add(graph, quantize_task, 0);
+	for(unsigned int c = 0; c < 3; ++c)
+		graph_depend(graph, quantize, resample_tasks[c]);
+	graph_depend(graph, graph_add(graph, write_cg3_task, 0), quantize);
+	if(preview_index)
+		graph_depend(graph, graph_add(graph, write_preview_task, 0), quantize);
 	if(scaled_index)
 	{
-		//convert RGB image to RGBA image
-		image_size = 4 * scaled_image.height * scaled_image.width;
-		unsigned char* output_image = (unsigned char*)malloc(image_size * sizeof(unsigned char));
-		fill_RGBA_image(output_image, &scaled_image);
-		delete_pixel_image(&scaled_image);
-		printf("Converted RGB image to RGBA\n");
+		unsigned int write_scaled = graph_add(graph, write_scaled_task, 0);
+		for(unsigned int c = 0; c < 3; ++c)
+			graph_depend(graph, write_scaled, resample_tasks[c]);
+	}
+}
 
-		//Write scaled image to file
-		//TODO: enforce PNG file extension
-		error = lodepng_encode32_file(argv[scaled_index], output_image, scaled_image.width, scaled_image.height);
-		if(error)
+int main(int argc, char** argv)
+{
+	//Parse program arguments
+	debug_enable = 0;
+	tune_enable = 0;
+	unsigned int arg = 1;
+	if(argc == 1)
+	{
+		printf("Usage: -SOURCE <source file> -OUT <output binary> -SCLAED <output scaled image> -MAGNITUDE <output magnitude image> -PREVIEW <output preview image> -WISDOM <FFT wisdom file> -TUNE -THREADS <number of threads> -PRECISION <FLOAT|HALF|INT16> -RESAMPLE <DFT|BOX|BILINEAR|BICUBIC|LANCZOS3> -DECIMATE <factor> -DEBUG\n");
+		printf("-SCALED -MAGNITUDE, -PREVIEW, -WISDOM, -TUNE, -THREADS, -PRECISION, -RESAMPLE, -DECIMATE and -DEBUG are optional\n");
+		printf("-TUNE measures the FFT strategies for lengths not in the wisdom file and saves the results to it\n");
+		printf("-PRECISION HALF or INT16 stores the -MAGNITUDE spectrum in 16 bits, this halves the spectrum but only saves about 10%% of the peak memory, and the darkest bins of the plot can move by 10 or more levels\n");
+		printf("-RESAMPLE picks a spatial filter instead of the default DFT resize, much faster on large sources\n");
+		printf("-DECIMATE shrinks large sources to factor times the output size before the DFT resize, 1 is fastest, 2 or more is close to the full resize\n");
+		exit(1);
+	}
+	while(arg < (unsigned int)argc)
+	{
+		if(argv[arg][0] == '-')
+		{
+			to_caps(argv[arg]);
+			if(str_comp_partial(source_string, argv[arg]))
+			{
+				source_index = ++arg;
+			}
+			else if(str_comp_partial(out_string, argv[arg]))
+			{
+				out_index = ++arg;
+			}
+			else if(str_comp_partial(scaled_string, argv[arg]))
+			{
+				scaled_index = ++arg;
+			}
+			else if(str_comp_partial(magnitude_string, argv[arg]))
+			{
+				magnitude_index = ++arg;
+			}
+			else if(str_comp_partial(preview_string, argv[arg]))
+			{
+				preview_index = ++arg;
+			}
+			else if(str_comp_partial(debug_string, argv[arg]))
+			{
+				debug_enable = 0xFF;
+			}
+			else if(str_comp_partial(wisdom_string, argv[arg]))
+			{
+				wisdom_index = ++arg;
+			}
+			else if(str_comp_partial(tune_string, argv[arg]))
+			{
+				tune_enable = 0xFF;
+			}
+			else if(str_comp_partial(threads_string, argv[arg]))
+			{
+				int threads = atoi(option_value(argc, argv, &arg));
+				if(threads < 1 || threads > MAX_THREADS)
+				{
+					printf("Invalid arguments!\n");
+					exit(1);
+				}
+				num_threads = threads;
+			}
+			else if(str_comp_partial(precision_string, argv[arg]))
+			{
+				to_caps(option_value(argc, argv, &arg));
+				if(str_comp("FLOAT", argv[arg]))
+					spectrum_precision = SPECTRUM_FLOAT;
+				else if(str_comp("HALF", argv[arg]))
+					spectrum_precision = SPECTRUM_HALF;
+				else if(str_comp("INT16", argv[arg]))
+					spectrum_precision = SPECTRUM_INT16;
+				else
+				{
+					printf("Unknown precision %s!\n", argv[arg]);
+					exit(1);
+				}
+			}
+			else if(str_comp_partial(resample_string, argv[arg]))
+			{
+				to_caps(option_value(argc, argv, &arg));
+				for(resample_index = 0; resample_index < NUM_RESAMPLE_FILTERS; ++resample_index)
+				{
+					if(str_comp(resample_filters[resample_index].name, argv[arg]))
+						break;
+				}
+				if(resample_index == NUM_RESAMPLE_FILTERS)
+				{
+					printf("Unknown resampler %s!\n", argv[arg]);
+					exit(1);
+				}
+			}
+			else if(str_comp_partial(decimate_string, argv[arg]))
+			{
+				int factor = atoi(option_value(argc, argv, &arg));
+				if(factor < 1)
+				{
+					printf("Invalid arguments!\n");
+					exit(1);
+				}
+				decimate_factor = factor;
+			}
+			++arg;
+		}
+		else
 		{
-			printf("error %u: %s\n", error, lodepng_error_text(error));
-			return 1;
+			source_index = arg++;
 		}
-		free(output_image);
-		printf("Wrote scaled image\n");
-		return 0;
 	}
+	if(arg > (unsigned int)argc)
+	{
+		printf("Invalid arguments!\n");
+		exit(1);
+	}
+	if(source_index == 0)
+	{
+		printf("No source file specified!\n");
+		exit(1);
+	}
+	if(out_index == 0)
+	{
+		printf("No output file specified!\n");
+		exit(1);
+	}
+
+	if(wisdom_index)
+	{
+		if(fft_wisdom_load(argv[wisdom_index]))
+			printf("No FFT wisdom loaded from %s\n", argv[wisdom_index]);
+		else
+			printf("Loaded FFT wisdom\n");
+	}
+	fft_set_tuning(tune_enable);
+	printf("FFT kernels: %s\n", fft_simd_name());
+	pool_start(num_threads, fft_thread_cleanup);
+	printf("Using %u threads\n", num_threads);
+
+	//the conversion runs as a task graph, see add_conversion_tasks()
+	conversion conv;
+	conv.argv = argv;
+	unsigned error = decode_png_planes(argv[source_index], conv.real_planes, &conv.width, &conv.height);
+	if(error)
+	{
+		printf("error %u: %s\n", error, lodepng_error_text(error));
+		return 1;
+	}
+	printf("Loaded image\n");
+	printf("Width is: %u\n", conv.width);
+	printf("Height is: %u\n", conv.height);
+	printf("Image red channel at 0: %u\n", (unsigned int)conv.real_planes[0][0]);
+	printf("Image green channel at 0: %u\n", (unsigned int)conv.real_planes[1][0]);
+	printf("Image blue channel at 0: %u\n", (unsigned int)conv.real_planes[2][0]);
+
+	conv.error = 0;
+
+	task_graph graph;
+	graph_init(&graph, &conv);
+	add_conversion_tasks(&graph);
+	graph_run(&graph);
+
+	if(tune_enable && wisdom_index)
+	{
+		if(fft_wisdom_save(argv[wisdom_index]))
+			printf("Error writing FFT wisdom!\n");
+		else
+			printf("Wrote FFT wisdom\n");
+	}
+	pool_stop();
+	fft_cleanup();
+	return conv.error ? 1 : 0;
 }
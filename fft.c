@@ -0,0 +1,1013 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <math.h>
+#include <complex.h>
+#include "fft.h"
+
+#define PI 3.14159265358979323846
+#define MAX_FACTORS 32
+//prime factors above this go through Bluestein instead of an O(p) per point odd radix stage
+#define FFT_MAX_DIRECT_RADIX 31
+
+//complex multiply without the C99 Annex G NaN/Inf recovery (__mulsc3)
+static inline float complex cmul(float complex a, float complex b)
+{
+	float ar = crealf(a);
+	float ai = cimagf(a);
+	float br = crealf(b);
+	float bi = cimagf(b);
+	return (ar * br - ai * bi) + I * (ar * bi + ai * br);
+}
+
+//multiply by direction * i
+static inline float complex rot(float complex a, int direction)
+{
+	if(direction < 0)
+		return cimagf(a) - I * crealf(a);
+	return -cimagf(a) + I * crealf(a);
+}
+
+#include "fft_codelets.h"
+
+//Strategies a complex plan can be built with. Without wisdom a plan uses a generated codelet when
+//there is one, FFT_STRATEGY_RADIX4 otherwise, or Bluestein when a prime factor is above FFT_MAX_DIRECT_RADIX.
+#define FFT_STRATEGY_DEFAULT 0
+#define FFT_STRATEGY_RADIX4 1	//radix 4 stages first, then 2, then odd primes ascending
+#define FFT_STRATEGY_RADIX2 2	//radix 2 stages only for the power of two part
+#define FFT_STRATEGY_ODD_FIRST 3	//odd primes first, then radix 4 and 2
+#define FFT_STRATEGY_BLUESTEIN 4
+#define FFT_STRATEGY_CODELET 5	//fixed length inverse from fft_codelets.h
+#define FFT_NUM_STRATEGIES 6
+
+static const char* fft_strategy_names[FFT_NUM_STRATEGIES] = {"default", "radix4", "radix2", "oddfirst", "bluestein", "codelet"};
+
+//split num_points into stage radices in the order given by strategy
+static unsigned int fft_factorize(unsigned int num_points, unsigned int* factors, int strategy)
+{
+	unsigned int num_factors = 0;
+	unsigned int num_twos = 0;
+	unsigned int num_odd = 0;
+	unsigned int odd[MAX_FACTORS];
+	while(num_points && ((num_points % 2) == 0))
+	{
+		++num_twos;
+		num_points = num_points / 2;
+	}
+	for(unsigned int p = 3; num_points > 1; p = p + 2)
+	{
+		if(p * p > num_points)
+		{
+			odd[num_odd++] = num_points;	//what remains is prime
+			break;
+		}
+		while((num_points % p) == 0)
+		{
+			odd[num_odd++] = p;
+			num_points = num_points / p;
+		}
+	}
+	if(strategy == FFT_STRATEGY_ODD_FIRST)
+	{
+		for(unsigned int d = 0; d < num_odd; ++d)
+			factors[num_factors++] = odd[d];
+	}
+	if(strategy != FFT_STRATEGY_RADIX2)
+	{
+		for(; num_twos >= 2; num_twos = num_twos - 2)
+			factors[num_factors++] = 4;
+	}
+	for(; num_twos; --num_twos)
+		factors[num_factors++] = 2;
+	if(strategy != FFT_STRATEGY_ODD_FIRST)
+	{
+		for(unsigned int d = 0; d < num_odd; ++d)
+			factors[num_factors++] = odd[d];
+	}
+	return num_factors;
+}
+
+//Each stage is one Stockham autosort pass: x holds p interleaved sub-sequences of length m with stride s,
+//y receives the p point butterflies with twiddles applied, w_n^(j*q) = twiddles[q * (p - 1) + j - 1].
+static void fft_radix2(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles)
+{
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		float complex w1 = twiddles[q];
+		for(unsigned int k = 0; k < s; ++k)
+		{
+			float complex a0 = x[k + s * q];
+			float complex a1 = x[k + s * (q + m)];
+			y[k + s * (2 * q)] = a0 + a1;
+			y[k + s * (2 * q + 1)] = cmul(a0 - a1, w1);
+		}
+	}
+}
+
+static void fft_radix3(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	const float half_sqrt3 = 0.86602540378443864676;
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		float complex w1 = twiddles[2 * q];
+		float complex w2 = twiddles[2 * q + 1];
+		for(unsigned int k = 0; k < s; ++k)
+		{
+			float complex a0 = x[k + s * q];
+			float complex a1 = x[k + s * (q + m)];
+			float complex a2 = x[k + s * (q + 2 * m)];
+			float complex t = a1 + a2;
+			float complex mid = a0 - 0.5f * t;
+			float complex d = half_sqrt3 * rot(a1 - a2, direction);
+			y[k + s * (3 * q)] = a0 + t;
+			y[k + s * (3 * q + 1)] = cmul(mid + d, w1);
+			y[k + s * (3 * q + 2)] = cmul(mid - d, w2);
+		}
+	}
+}
+
+static void fft_radix4(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		float complex w1 = twiddles[3 * q];
+		float complex w2 = twiddles[3 * q + 1];
+		float complex w3 = twiddles[3 * q + 2];
+		for(unsigned int k = 0; k < s; ++k)
+		{
+			float complex a0 = x[k + s * q];
+			float complex a1 = x[k + s * (q + m)];
+			float complex a2 = x[k + s * (q + 2 * m)];
+			float complex a3 = x[k + s * (q + 3 * m)];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, direction);
+			y[k + s * (4 * q)] = t0 + t2;
+			y[k + s * (4 * q + 1)] = cmul(t1 + t3, w1);
+			y[k + s * (4 * q + 2)] = cmul(t0 - t2, w2);
+			y[k + s * (4 * q + 3)] = cmul(t1 - t3, w3);
+		}
+	}
+}
+
+static void fft_radix5(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	const float c1 = 0.30901699437494742410;	//cos(2*pi/5)
+	const float c2 = -0.80901699437494742410;	//cos(4*pi/5)
+	const float s1 = 0.95105651629515357212;	//sin(2*pi/5)
+	const float s2 = 0.58778525229247312917;	//sin(4*pi/5)
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		float complex w1 = twiddles[4 * q];
+		float complex w2 = twiddles[4 * q + 1];
+		float complex w3 = twiddles[4 * q + 2];
+		float complex w4 = twiddles[4 * q + 3];
+		for(unsigned int k = 0; k < s; ++k)
+		{
+			float complex a0 = x[k + s * q];
+			float complex a1 = x[k + s * (q + m)];
+			float complex a2 = x[k + s * (q + 2 * m)];
+			float complex a3 = x[k + s * (q + 3 * m)];
+			float complex a4 = x[k + s * (q + 4 * m)];
+			float complex t1 = a1 + a4;
+			float complex t2 = a2 + a3;
+			float complex d1 = rot(a1 - a4, direction);
+			float complex d2 = rot(a2 - a3, direction);
+			float complex m1 = a0 + c1 * t1 + c2 * t2;
+			float complex m2 = a0 + c2 * t1 + c1 * t2;
+			float complex n1 = s1 * d1 + s2 * d2;
+			float complex n2 = s2 * d1 - s1 * d2;
+			y[k + s * (5 * q)] = a0 + t1 + t2;
+			y[k + s * (5 * q + 1)] = cmul(m1 + n1, w1);
+			y[k + s * (5 * q + 2)] = cmul(m2 + n2, w2);
+			y[k + s * (5 * q + 3)] = cmul(m2 - n2, w3);
+			y[k + s * (5 * q + 4)] = cmul(m1 - n1, w4);
+		}
+	}
+}
+
+//any odd radix, used for 7 and larger prime factors up to FFT_MAX_DIRECT_RADIX
+//pairs a_r with a_(p-r) so each output pair j, p-j shares one set of products
+//cos_p[r] = cos(2 * pi * r / p), sin_p[r] = sin(2 * pi * r / p)
+static void fft_radix_odd(const float complex* x, float complex* y, unsigned int p, unsigned int m, unsigned int s, const float complex* twiddles, const float* cos_p, const float* sin_p, int direction)
+{
+	unsigned int half = p / 2;
+	float complex sums[FFT_MAX_DIRECT_RADIX / 2 + 1];
+	float complex diffs[FFT_MAX_DIRECT_RADIX / 2 + 1];
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		const float complex* w = twiddles + q * (p - 1);
+		for(unsigned int k = 0; k < s; ++k)
+		{
+			float complex a0 = x[k + s * q];
+			float complex total = a0;
+			for(unsigned int r = 1; r <= half; ++r)
+			{
+				float complex ar = x[k + s * (q + r * m)];
+				float complex ap = x[k + s * (q + (p - r) * m)];
+				sums[r] = ar + ap;
+				diffs[r] = rot(ar - ap, direction);
+				total = total + sums[r];
+			}
+			y[k + s * (p * q)] = total;
+			for(unsigned int j = 1; j <= half; ++j)
+			{
+				float complex c_part = a0;
+				float complex s_part = 0.0;
+				unsigned int index = 0;
+				for(unsigned int r = 1; r <= half; ++r)
+				{
+					index = index + j;
+					if(index >= p)
+						index = index - p;
+					c_part = c_part + cos_p[index] * sums[r];
+					s_part = s_part + sin_p[index] * diffs[r];
+				}
+				y[k + s * (p * q + j)] = cmul(c_part + s_part, w[j - 1]);
+				y[k + s * (p * q + p - j)] = cmul(c_part - s_part, w[p - j - 1]);
+			}
+		}
+	}
+}
+
+//smallest length >= min_points with no prime factors other than 2, 3 and 5
+static unsigned int fft_good_size(unsigned int min_points)
+{
+	unsigned int best = 1;
+	while(best < min_points)
+		best = best << 1;
+	for(unsigned int p5 = 1; p5 < best; p5 = p5 * 5)
+	{
+		for(unsigned int p35 = p5; p35 < best; p35 = p35 * 3)
+		{
+			unsigned int size = p35;
+			while(size < min_points)
+				size = size << 1;
+			if(size < best)
+				best = size;
+		}
+	}
+	return best;
+}
+
+#define FFT_C2C 0
+#define FFT_R2C 1
+#define FFT_C2R 2
+
+//stage kernels with the signature of fft_radix3(), the vector ones come from fft_simd.h
+typedef void (*fft_stage_kernel)(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction);
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FFT_SIMD_SUFFIX sse2
+#define FFT_SIMD_TARGET __attribute__((target("sse2")))
+#define FFT_SIMD_FLOATS 4
+#define FFT_SIMD_PAIRS(a, b) a, b, a, b
+#define FFT_SIMD_SWAP_MASK 1, 0, 3, 2
+#include "fft_simd.h"
+#undef FFT_SIMD_SUFFIX
+#undef FFT_SIMD_TARGET
+#undef FFT_SIMD_FLOATS
+#undef FFT_SIMD_PAIRS
+#undef FFT_SIMD_SWAP_MASK
+
+#define FFT_SIMD_SUFFIX avx2
+#define FFT_SIMD_TARGET __attribute__((target("avx2")))
+#define FFT_SIMD_FLOATS 8
+#define FFT_SIMD_PAIRS(a, b) a, b, a, b, a, b, a, b
+#define FFT_SIMD_SWAP_MASK 1, 0, 3, 2, 5, 4, 7, 6
+#include "fft_simd.h"
+#undef FFT_SIMD_SUFFIX
+#undef FFT_SIMD_TARGET
+#undef FFT_SIMD_FLOATS
+#undef FFT_SIMD_PAIRS
+#undef FFT_SIMD_SWAP_MASK
+
+#define FFT_SIMD_SUFFIX avx512
+#define FFT_SIMD_TARGET __attribute__((target("avx512f")))
+#define FFT_SIMD_FLOATS 16
+#define FFT_SIMD_PAIRS(a, b) a, b, a, b, a, b, a, b, a, b, a, b, a, b, a, b
+#define FFT_SIMD_SWAP_MASK 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
+#include "fft_simd.h"
+#undef FFT_SIMD_SUFFIX
+#undef FFT_SIMD_TARGET
+#undef FFT_SIMD_FLOATS
+#undef FFT_SIMD_PAIRS
+#undef FFT_SIMD_SWAP_MASK
+
+#define FFT_X86_KERNELS
+#endif
+
+//one instruction set's stage kernels, lanes complex values per vector
+typedef struct FFT_ISA
+{
+	const char* name;
+	const char* cpu_feature;
+	unsigned int lanes;
+	fft_stage_kernel radix2;
+	fft_stage_kernel radix3;
+	fft_stage_kernel radix4;
+	fft_stage_kernel radix5;
+} fft_isa;
+
+//widest first
+static const fft_isa fft_isas[] =
+{
+#ifdef FFT_X86_KERNELS
+	{"AVX-512", "avx512f", 8, fft_radix2_avx512, fft_radix3_avx512, fft_radix4_avx512, fft_radix5_avx512},
+	{"AVX2", "avx2", 4, fft_radix2_avx2, fft_radix3_avx2, fft_radix4_avx2, fft_radix5_avx2},
+	{"SSE2", "sse2", 2, fft_radix2_sse2, fft_radix3_sse2, fft_radix4_sse2, fft_radix5_sse2},
+#endif
+	{"scalar", NULL, 1, NULL, NULL, NULL, NULL}
+};
+#define FFT_NUM_ISAS (sizeof(fft_isas) / sizeof(fft_isas[0]))
+
+static int fft_first_isa;	//widest instruction set the CPU supports
+static pthread_once_t fft_isa_once = PTHREAD_ONCE_INIT;
+
+static void fft_detect_isa(void)
+{
+	fft_first_isa = FFT_NUM_ISAS - 1;
+#ifdef FFT_X86_KERNELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f"))
+		fft_first_isa = 0;
+	else if(__builtin_cpu_supports("avx2"))
+		fft_first_isa = 1;
+	else if(__builtin_cpu_supports("sse2"))
+		fft_first_isa = 2;
+#endif
+}
+
+static void fft_select_isa(void)
+{
+	pthread_once(&fft_isa_once, fft_detect_isa);
+}
+
+//widest supported vector kernel for a radix p stage with stride s, NULL for the scalar stages
+static fft_stage_kernel fft_select_stage_kernel(unsigned int p, unsigned int s)
+{
+	fft_select_isa();
+	for(unsigned int i = fft_first_isa; i < FFT_NUM_ISAS; ++i)
+	{
+		if(s % fft_isas[i].lanes)
+			continue;
+		switch(p)
+		{
+			case 2:
+				return fft_isas[i].radix2;
+			case 3:
+				return fft_isas[i].radix3;
+			case 4:
+				return fft_isas[i].radix4;
+			case 5:
+				return fft_isas[i].radix5;
+			default:
+				return NULL;
+		}
+	}
+	return NULL;
+}
+
+const char* fft_simd_name(void)
+{
+	fft_select_isa();
+	return fft_isas[fft_first_isa].name;
+}
+
+struct FFT_PLAN
+{
+	int kind;
+	unsigned int num_points;
+	int direction;
+	int strategy;
+	fft_codelet codelet;
+
+	//mixed radix stages
+	unsigned int num_factors;
+	unsigned int factors[MAX_FACTORS];
+	float complex* stage_twiddles[MAX_FACTORS];
+	fft_stage_kernel stage_kernels[MAX_FACTORS];	//vector kernel or NULL
+	float* odd_cos[MAX_FACTORS];	//only for radix above 5
+	float* odd_sin[MAX_FACTORS];
+	float complex* scratch;
+
+	//Bluestein, used when conv_points is not 0
+	unsigned int conv_points;
+	float complex* chirp;
+	float complex* chirp_spectrum;	//transform of the conjugate chirp, scaled by 1 / conv_points
+	fft_plan* conv_forward;
+	fft_plan* conv_inverse;
+	float complex* conv_buffer;
+	float complex* conv_spectrum;
+
+	//real transforms run through a complex plan of half the length (full length if odd)
+	fft_plan* complex_plan;
+	float complex* real_twiddles;
+	float complex* packed;
+	float complex* packed_spectrum;
+
+	fft_plan* next;
+};
+
+//every thread has its own plans, since a plan's scratch space allows one transform at a time
+static __thread fft_plan* plan_cache = NULL;
+
+//wisdom: the strategy measured fastest for a complex transform of one length and direction
+typedef struct FFT_WISDOM
+{
+	unsigned int num_points;
+	int direction;
+	int strategy;
+	struct FFT_WISDOM* next;
+} fft_wisdom;
+
+static fft_wisdom* wisdom = NULL;	//shared by all threads, guarded by wisdom_lock
+static pthread_mutex_t wisdom_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread unsigned int wisdom_lock_depth = 0;	//times this thread has taken wisdom_lock
+static int tuning_enable = 0;
+
+//wisdom_lock may be taken again by the thread holding it: tuning a Bluestein candidate plans
+//(and maybe tunes) the convolution length while the outer length's lookup still holds the lock
+static void wisdom_acquire(void)
+{
+	if(wisdom_lock_depth++ == 0)
+		pthread_mutex_lock(&wisdom_lock);
+}
+
+static void wisdom_release(void)
+{
+	if(--wisdom_lock_depth == 0)
+		pthread_mutex_unlock(&wisdom_lock);
+}
+
+static fft_plan* fft_plan_get(int kind, unsigned int num_points, int direction);
+
+//exp(direction * 2 * pi * i * numerator / denominator)
+static float complex fft_twiddle(unsigned long long numerator, unsigned long long denominator, int direction)
+{
+	double angle = 2.0 * PI * (double)numerator / (double)denominator;
+	return (float)cos(angle) + I * ((float)direction * (float)sin(angle));
+}
+
+//Bluestein (chirp-z): n*k = (n^2 + k^2 - (k-n)^2) / 2 turns the transform into a convolution
+//with the chirp c_n = exp(direction * pi * i * n^2 / N), evaluated with smooth length FFTs.
+static void fft_plan_bluestein(fft_plan* plan)
+{
+	unsigned int num_points = plan->num_points;
+	unsigned int conv_points = fft_good_size(2 * num_points - 1);
+	plan->conv_points = conv_points;
+	plan->chirp = (float complex*)malloc(sizeof(float complex) * num_points);
+	plan->chirp_spectrum = (float complex*)malloc(sizeof(float complex) * conv_points);
+	plan->conv_buffer = (float complex*)malloc(sizeof(float complex) * conv_points);
+	plan->conv_spectrum = (float complex*)malloc(sizeof(float complex) * conv_points);
+	plan->conv_forward = fft_plan_get(FFT_C2C, conv_points, FFT_FORWARD);
+	plan->conv_inverse = fft_plan_get(FFT_C2C, conv_points, FFT_INVERSE);
+
+	for(unsigned int d = 0; d < num_points; ++d)
+	{
+		//reduce n^2 mod 2N first so the angle keeps its precision for long transforms
+		unsigned long long square = ((unsigned long long)d * d) % (2ULL * num_points);
+		plan->chirp[d] = fft_twiddle(square, 2ULL * num_points, plan->direction);
+	}
+
+	float complex* b = plan->conv_buffer;
+	for(unsigned int d = 0; d < conv_points; ++d)
+	{
+		b[d] = 0.0;
+	}
+	b[0] = conjf(plan->chirp[0]);
+	for(unsigned int d = 1; d < num_points; ++d)
+	{
+		b[d] = conjf(plan->chirp[d]);
+		b[conv_points - d] = conjf(plan->chirp[d]);
+	}
+	fft_execute(plan->conv_forward, b, plan->chirp_spectrum);
+	float scale = 1.0f / (float)conv_points;
+	for(unsigned int d = 0; d < conv_points; ++d)
+	{
+		plan->chirp_spectrum[d] = plan->chirp_spectrum[d] * scale;
+	}
+}
+
+static void fft_execute_bluestein(fft_plan* plan, float complex* input, float complex* output)
+{
+	unsigned int num_points = plan->num_points;
+	unsigned int conv_points = plan->conv_points;
+	float complex* a = plan->conv_buffer;
+	float complex* spectrum_a = plan->conv_spectrum;
+
+	for(unsigned int d = 0; d < num_points; ++d)
+	{
+		a[d] = cmul(input[d], plan->chirp[d]);
+	}
+	for(unsigned int d = num_points; d < conv_points; ++d)
+	{
+		a[d] = 0.0;
+	}
+	fft_execute(plan->conv_forward, a, spectrum_a);
+	for(unsigned int d = 0; d < conv_points; ++d)
+	{
+		spectrum_a[d] = cmul(spectrum_a[d], plan->chirp_spectrum[d]);
+	}
+	fft_execute(plan->conv_inverse, spectrum_a, a);
+	for(unsigned int d = 0; d < num_points; ++d)
+	{
+		output[d] = cmul(a[d], plan->chirp[d]);
+	}
+}
+
+static void fft_plan_mixed_radix(fft_plan* plan)
+{
+	unsigned int n = plan->num_points;
+	unsigned int s = 1;
+	for(unsigned int f = 0; f < plan->num_factors; ++f)
+	{
+		unsigned int p = plan->factors[f];
+		unsigned int m = n / p;
+		plan->stage_kernels[f] = fft_select_stage_kernel(p, s);
+		s = s * p;
+		float complex* twiddles = (float complex*)malloc(sizeof(float complex) * (p - 1) * m);
+		for(unsigned int q = 0; q < m; ++q)
+		{
+			for(unsigned int j = 1; j < p; ++j)
+			{
+				twiddles[q * (p - 1) + j - 1] = fft_twiddle((unsigned long long)j * q, n, plan->direction);
+			}
+		}
+		plan->stage_twiddles[f] = twiddles;
+		if(p > 5)
+		{
+			plan->odd_cos[f] = (float*)malloc(sizeof(float) * p);
+			plan->odd_sin[f] = (float*)malloc(sizeof(float) * p);
+			for(unsigned int r = 0; r < p; ++r)
+			{
+				plan->odd_cos[f][r] = cos(2.0 * PI * (double)r / (double)p);
+				plan->odd_sin[f][r] = sin(2.0 * PI * (double)r / (double)p);
+			}
+		}
+		n = m;
+	}
+	plan->scratch = (float complex*)malloc(sizeof(float complex) * plan->num_points);
+}
+
+static void fft_plan_real(fft_plan* plan)
+{
+	unsigned int num_points = plan->num_points;
+	if(num_points & 1)
+	{
+		plan->complex_plan = fft_plan_get(FFT_C2C, num_points, plan->direction);
+		plan->packed = (float complex*)malloc(sizeof(float complex) * num_points);
+		plan->packed_spectrum = (float complex*)malloc(sizeof(float complex) * num_points);
+		return;
+	}
+	unsigned int half = num_points / 2;
+	plan->complex_plan = fft_plan_get(FFT_C2C, half, plan->direction);
+	plan->packed = (float complex*)malloc(sizeof(float complex) * half);
+	plan->packed_spectrum = (float complex*)malloc(sizeof(float complex) * half);
+	plan->real_twiddles = (float complex*)malloc(sizeof(float complex) * (half + 1));
+	for(unsigned int k = 0; k <= half; ++k)
+	{
+		plan->real_twiddles[k] = fft_twiddle(k, num_points, plan->direction);
+	}
+}
+
+//largest prime factor, 1 for num_points <= 1
+static unsigned int fft_largest_factor(unsigned int num_points)
+{
+	unsigned int factors[MAX_FACTORS];
+	unsigned int num_factors = fft_factorize(num_points, factors, FFT_STRATEGY_RADIX2);
+	return num_factors ? factors[num_factors - 1] : 1;
+}
+
+static fft_plan* fft_plan_create(int kind, unsigned int num_points, int direction, int strategy)
+{
+	fft_plan* plan = (fft_plan*)calloc(1, sizeof(fft_plan));
+	plan->kind = kind;
+	plan->num_points = num_points;
+	plan->direction = direction;
+	if(kind != FFT_C2C)
+	{
+		fft_plan_real(plan);
+		return plan;
+	}
+	fft_codelet codelet = (direction == FFT_INVERSE) ? fft_codelet_inverse(num_points) : NULL;
+	if(fft_largest_factor(num_points) > FFT_MAX_DIRECT_RADIX)
+		strategy = FFT_STRATEGY_BLUESTEIN;
+	if(strategy == FFT_STRATEGY_DEFAULT)
+		strategy = codelet ? FFT_STRATEGY_CODELET : FFT_STRATEGY_RADIX4;
+	if((strategy == FFT_STRATEGY_CODELET) && !codelet)
+		strategy = FFT_STRATEGY_RADIX4;
+	plan->strategy = strategy;
+	if(strategy == FFT_STRATEGY_CODELET)
+	{
+		plan->codelet = codelet;	//no tables to build, they are static
+		return plan;
+	}
+	if(strategy == FFT_STRATEGY_BLUESTEIN)
+	{
+		fft_plan_bluestein(plan);
+		return plan;
+	}
+	plan->num_factors = fft_factorize(num_points, plan->factors, strategy);
+	fft_plan_mixed_radix(plan);
+	return plan;
+}
+
+static void fft_plan_destroy(fft_plan* plan)
+{
+	for(unsigned int f = 0; f < plan->num_factors; ++f)
+	{
+		free(plan->stage_twiddles[f]);
+		free(plan->odd_cos[f]);
+		free(plan->odd_sin[f]);
+	}
+	free(plan->scratch);
+	free(plan->chirp);
+	free(plan->chirp_spectrum);
+	free(plan->conv_buffer);
+	free(plan->conv_spectrum);
+	free(plan->real_twiddles);
+	free(plan->packed);
+	free(plan->packed_spectrum);
+	free(plan);
+}
+
+static double fft_seconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+//best of three runs of enough repetitions to cover about a million points
+static double fft_time_plan(fft_plan* plan, float complex* input, float complex* output)
+{
+	unsigned int repetitions = 1 + (1 << 20) / plan->num_points;
+	double best = 1e30;
+	for(unsigned int trial = 0; trial < 3; ++trial)
+	{
+		double start = fft_seconds();
+		for(unsigned int d = 0; d < repetitions; ++d)
+		{
+			fft_execute(plan, input, output);
+		}
+		double elapsed = fft_seconds() - start;
+		if(elapsed < best)
+			best = elapsed;
+	}
+	return best;
+}
+
+static int fft_wisdom_lookup(unsigned int num_points, int direction)
+{
+	int strategy = FFT_STRATEGY_DEFAULT;
+	wisdom_acquire();
+	for(fft_wisdom* entry = wisdom; entry; entry = entry->next)
+	{
+		if((entry->num_points == num_points) && (entry->direction == direction))
+		{
+			strategy = entry->strategy;
+			break;
+		}
+	}
+	wisdom_release();
+	return strategy;
+}
+
+static void fft_wisdom_add(unsigned int num_points, int direction, int strategy)
+{
+	wisdom_acquire();
+	fft_wisdom* entry = wisdom;
+	while(entry && ((entry->num_points != num_points) || (entry->direction != direction)))
+		entry = entry->next;
+	if(!entry)
+	{
+		entry = (fft_wisdom*)malloc(sizeof(fft_wisdom));
+		entry->num_points = num_points;
+		entry->direction = direction;
+		entry->next = wisdom;
+		wisdom = entry;
+	}
+	entry->strategy = strategy;
+	wisdom_release();
+}
+
+//measures every strategy that makes sense for num_points and returns the fastest
+static int fft_tune(unsigned int num_points, int direction)
+{
+	unsigned int largest_factor = fft_largest_factor(num_points);
+	if(largest_factor > FFT_MAX_DIRECT_RADIX)
+		return FFT_STRATEGY_BLUESTEIN;
+	int candidates[FFT_NUM_STRATEGIES];
+	unsigned int num_candidates = 0;
+	candidates[num_candidates++] = FFT_STRATEGY_RADIX4;
+	if((num_points % 4) == 0)
+		candidates[num_candidates++] = FFT_STRATEGY_RADIX2;
+	if(((num_points % 2) == 0) && (largest_factor > 2))
+		candidates[num_candidates++] = FFT_STRATEGY_ODD_FIRST;
+	if(largest_factor >= 7)
+		candidates[num_candidates++] = FFT_STRATEGY_BLUESTEIN;
+	if((direction == FFT_INVERSE) && fft_codelet_inverse(num_points))
+		candidates[num_candidates++] = FFT_STRATEGY_CODELET;
+	if(num_candidates == 1)
+		return candidates[0];
+
+	float complex* input = (float complex*)malloc(sizeof(float complex) * num_points);
+	float complex* output = (float complex*)malloc(sizeof(float complex) * num_points);
+	for(unsigned int d = 0; d < num_points; ++d)
+	{
+		input[d] = (float)(d % 17) - I * (float)(d % 5);
+	}
+	int best_strategy = candidates[0];
+	double best_time = 1e30;
+	for(unsigned int c = 0; c < num_candidates; ++c)
+	{
+		fft_plan* plan = fft_plan_create(FFT_C2C, num_points, direction, candidates[c]);
+		double elapsed = fft_time_plan(plan, input, output);
+		fft_plan_destroy(plan);
+		if(elapsed < best_time)
+		{
+			best_time = elapsed;
+			best_strategy = candidates[c];
+		}
+	}
+	free(output);
+	free(input);
+	printf("FFT: Tuned %s length %u: %s\n", (direction == FFT_FORWARD) ? "forward" : "inverse", num_points, fft_strategy_names[best_strategy]);
+	return best_strategy;
+}
+
+//plans are shared by everything that transforms the same length in the same direction
+static fft_plan* fft_plan_get(int kind, unsigned int num_points, int direction)
+{
+	for(fft_plan* plan = plan_cache; plan; plan = plan->next)
+	{
+		if((plan->kind == kind) && (plan->num_points == num_points) && (plan->direction == direction))
+			return plan;
+	}
+	int strategy = FFT_STRATEGY_DEFAULT;
+	if(kind == FFT_C2C)
+	{
+		//held from the lookup until the result is added, so threads missing the same length at
+		//once wait for one measurement and all use its strategy instead of each tuning their own
+		wisdom_acquire();
+		strategy = fft_wisdom_lookup(num_points, direction);
+		if((strategy == FFT_STRATEGY_DEFAULT) && tuning_enable)
+		{
+			strategy = fft_tune(num_points, direction);
+			fft_wisdom_add(num_points, direction, strategy);
+		}
+		wisdom_release();
+	}
+	fft_plan* plan = fft_plan_create(kind, num_points, direction, strategy);
+	plan->next = plan_cache;
+	plan_cache = plan;
+	return plan;
+}
+
+void fft_set_tuning(int enable)
+{
+	tuning_enable = enable;
+}
+
+//one "c2c <length> <forward|inverse> <strategy>" line per entry, '#' starts a comment line
+int fft_wisdom_load(const char* filename)
+{
+	FILE* f = fopen(filename, "r");
+	if(!f)
+		return 1;
+	char line[128];
+	char direction_name[16];
+	char strategy_name[16];
+	unsigned int num_points;
+	while(fgets(line, sizeof(line), f))
+	{
+		if(line[0] == '#')
+			continue;
+		if(sscanf(line, "c2c %u %15s %15s", &num_points, direction_name, strategy_name) != 3)
+			continue;
+		int direction = strcmp(direction_name, "inverse") ? FFT_FORWARD : FFT_INVERSE;
+		for(int strategy = 1; strategy < FFT_NUM_STRATEGIES; ++strategy)
+		{
+			if(!strcmp(strategy_name, fft_strategy_names[strategy]))
+				fft_wisdom_add(num_points, direction, strategy);
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+int fft_wisdom_save(const char* filename)
+{
+	FILE* f = fopen(filename, "w");
+	if(!f)
+		return 1;
+	fprintf(f, "# png_to_6847 FFT wisdom\n");
+	wisdom_acquire();
+	for(fft_wisdom* entry = wisdom; entry; entry = entry->next)
+	{
+		fprintf(f, "c2c %u %s %s\n", entry->num_points, (entry->direction == FFT_FORWARD) ? "forward" : "inverse", fft_strategy_names[entry->strategy]);
+	}
+	wisdom_release();
+	fclose(f);
+	return 0;
+}
+
+fft_plan* fft_plan_c2c(unsigned int num_points, int direction)
+{
+	return fft_plan_get(FFT_C2C, num_points, direction);
+}
+
+fft_plan* fft_plan_r2c(unsigned int num_points)
+{
+	return fft_plan_get(FFT_R2C, num_points, FFT_FORWARD);
+}
+
+fft_plan* fft_plan_c2r(unsigned int num_points)
+{
+	return fft_plan_get(FFT_C2R, num_points, FFT_INVERSE);
+}
+
+void fft_thread_cleanup(void)
+{
+	while(plan_cache)
+	{
+		fft_plan* next = plan_cache->next;
+		fft_plan_destroy(plan_cache);
+		plan_cache = next;
+	}
+}
+
+void fft_cleanup(void)
+{
+	fft_thread_cleanup();
+	while(wisdom)
+	{
+		fft_wisdom* next = wisdom->next;
+		free(wisdom);
+		wisdom = next;
+	}
+}
+
+void fft_execute(fft_plan* plan, float complex* input, float complex* output)
+{
+	if(plan->codelet)
+	{
+		plan->codelet(input, output);
+		return;
+	}
+	if(plan->conv_points)
+	{
+		fft_execute_bluestein(plan, input, output);
+		return;
+	}
+	if(plan->num_factors == 0)
+	{
+		if(plan->num_points)
+			output[0] = input[0];
+		return;
+	}
+
+	//ping-pong between output and scratch so that the last stage lands in output
+	float complex* buffers[2];
+	buffers[0] = (plan->num_factors & 1) ? output : plan->scratch;
+	buffers[1] = (plan->num_factors & 1) ? plan->scratch : output;
+
+	const float complex* src = input;
+	unsigned int n = plan->num_points;
+	unsigned int s = 1;
+	int direction = plan->direction;
+	for(unsigned int f = 0; f < plan->num_factors; ++f)
+	{
+		unsigned int p = plan->factors[f];
+		unsigned int m = n / p;
+		const float complex* twiddles = plan->stage_twiddles[f];
+		float complex* dst = buffers[f & 1];
+		if(plan->stage_kernels[f])
+		{
+			plan->stage_kernels[f](src, dst, m, s, twiddles, direction);
+		}
+		else
+		{
+			switch(p)
+			{
+				case 2:
+					fft_radix2(src, dst, m, s, twiddles);
+					break;
+				case 3:
+					fft_radix3(src, dst, m, s, twiddles, direction);
+					break;
+				case 4:
+					fft_radix4(src, dst, m, s, twiddles, direction);
+					break;
+				case 5:
+					fft_radix5(src, dst, m, s, twiddles, direction);
+					break;
+				default:
+					fft_radix_odd(src, dst, p, m, s, twiddles, plan->odd_cos[f], plan->odd_sin[f], direction);
+					break;
+			}
+		}
+		src = dst;
+		n = m;
+		s = s * p;
+	}
+	return;
+}
+
+//Real input transform through a half length complex FFT: z_n = x_2n + i x_2n+1 gives
+//X_k = E_k + w^k O_k with E_k = (Z_k + conj(Z_h-k)) / 2 and O_k = (Z_k - conj(Z_h-k)) / 2i.
+//Odd lengths fall back to a full complex transform.
+void fft_execute_r2c(fft_plan* plan, float* input, float complex* output)
+{
+	unsigned int num_points = plan->num_points;
+	if(num_points & 1)
+	{
+		for(unsigned int d = 0; d < num_points; ++d)
+		{
+			plan->packed[d] = input[d];
+		}
+		fft_execute(plan->complex_plan, plan->packed, plan->packed_spectrum);
+		for(unsigned int d = 0; d <= num_points / 2; ++d)
+		{
+			output[d] = plan->packed_spectrum[d];
+		}
+		return;
+	}
+
+	unsigned int half = num_points / 2;
+	float complex* packed_spectrum = plan->packed_spectrum;
+	for(unsigned int d = 0; d < half; ++d)
+	{
+		plan->packed[d] = input[2 * d] + I * input[2 * d + 1];
+	}
+	fft_execute(plan->complex_plan, plan->packed, packed_spectrum);
+	for(unsigned int k = 0; k <= half; ++k)
+	{
+		float complex z_k = packed_spectrum[(k == half) ? 0 : k];
+		float complex z_mirror = conjf(packed_spectrum[(k == 0) ? 0 : half - k]);
+		float complex even = 0.5f * (z_k + z_mirror);
+		float complex odd = 0.5f * (z_k - z_mirror);
+		//odd / i = -i * odd
+		output[k] = even + cmul(rot(odd, FFT_FORWARD), plan->real_twiddles[k]);
+	}
+	return;
+}
+
+//Inverse of fft_execute_r2c. Bins 0 and N/2 only keep their real part, which makes the result
+//the real part of the complex inverse of any spectrum with this non-redundant half.
+void fft_execute_c2r(fft_plan* plan, float complex* input, float* output)
+{
+	unsigned int num_points = plan->num_points;
+	if(num_points & 1)
+	{
+		float complex* full_input = plan->packed;
+		full_input[0] = crealf(input[0]);
+		for(unsigned int d = 1; d <= num_points / 2; ++d)
+		{
+			full_input[d] = input[d];
+			full_input[num_points - d] = conjf(input[d]);
+		}
+		fft_execute(plan->complex_plan, full_input, plan->packed_spectrum);
+		for(unsigned int d = 0; d < num_points; ++d)
+		{
+			output[d] = crealf(plan->packed_spectrum[d]);
+		}
+		return;
+	}
+
+	unsigned int half = num_points / 2;
+	float complex* packed_spectrum = plan->packed_spectrum;
+	for(unsigned int k = 0; k < half; ++k)
+	{
+		float complex x_k = (k == 0) ? crealf(input[0]) : input[k];
+		float complex x_mirror = (k == 0) ? crealf(input[half]) : conjf(input[half - k]);
+		//Z_k = 2 E_k + 2 i O_k with the twiddle of O_k undone
+		packed_spectrum[k] = (x_k + x_mirror) + rot(cmul(x_k - x_mirror, plan->real_twiddles[k]), FFT_INVERSE);
+	}
+	fft_execute(plan->complex_plan, packed_spectrum, plan->packed);
+	for(unsigned int d = 0; d < half; ++d)
+	{
+		output[2 * d] = crealf(plan->packed[d]);
+		output[2 * d + 1] = cimagf(plan->packed[d]);
+	}
+	return;
+}
+
+void fft(float complex* input, unsigned int num_points, float complex* output, int direction)
+{
+	fft_execute(fft_plan_c2c(num_points, direction), input, output);
+}
+
+void fft_r2c(float* input, unsigned int num_points, float complex* output)
+{
+	fft_execute_r2c(fft_plan_r2c(num_points), input, output);
+}
+
+void fft_c2r(float complex* input, unsigned int num_points, float* output)
+{
+	fft_execute_c2r(fft_plan_c2r(num_points), input, output);
+}
@@ -0,0 +1,51 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex.h>
+
+#define FFT_FORWARD -1
+#define FFT_INVERSE 1
+
+//A plan holds everything a transform of one length and direction needs apart from the data:
+//factorization, per-stage twiddle tables, scratch space and Bluestein chirp spectra.
+//Plans are created on first use and cached per thread, since a plan's scratch space allows one
+//transform at a time. fft_thread_cleanup() frees the calling thread's plans, fft_cleanup() frees
+//the calling thread's plans and the wisdom. Wisdom is shared by all threads.
+typedef struct FFT_PLAN fft_plan;
+
+fft_plan* fft_plan_c2c(unsigned int num_points, int direction);
+fft_plan* fft_plan_r2c(unsigned int num_points);
+fft_plan* fft_plan_c2r(unsigned int num_points);
+void fft_thread_cleanup(void);
+void fft_cleanup(void);
+
+//Wisdom records which strategy (radix order, Bluestein or not) was fastest for each complex length.
+//With tuning enabled, a plan for a length that has no wisdom yet measures the candidates first.
+//load and save return 0 on success.
+void fft_set_tuning(int enable);
+int fft_wisdom_load(const char* filename);
+int fft_wisdom_save(const char* filename);
+
+//Name of the widest vector instruction set (AVX-512, AVX2, SSE2) the stage kernels use on this
+//CPU, "scalar" if none. Chosen once from CPUID, every choice gives the same results.
+const char* fft_simd_name(void);
+
+//Unnormalized mixed radix FFT (radix 4, 2, 3, 5, 7 and generic odd factors).
+//Lengths with a prime factor above 31 use Bluestein's algorithm, so every length is O(N log N).
+//Inverse transforms of 256, 192, 128 and 96 points run generated codelets (fft_codelets.h).
+//direction is FFT_FORWARD (exp(-2*pi*i*k*n/N)) or FFT_INVERSE (exp(+2*pi*i*k*n/N)).
+//input and output must not overlap.
+void fft_execute(fft_plan* plan, float complex* input, float complex* output);
+
+//Forward transform of real input, writes only the num_points / 2 + 1 non-redundant bins.
+void fft_execute_r2c(fft_plan* plan, float* input, float complex* output);
+
+//Unnormalized inverse of fft_execute_r2c, reads num_points / 2 + 1 bins and writes num_points real samples.
+void fft_execute_c2r(fft_plan* plan, float complex* input, float* output);
+
+//The same transforms through the cached plan for num_points.
+void fft(float complex* input, unsigned int num_points, float complex* output, int direction);
+void fft_r2c(float* input, unsigned int num_points, float complex* output);
+void fft_c2r(float complex* input, unsigned int num_points, float* output);
+
+#endif
@@ -0,0 +1,203 @@
+//Writes fft_codelets.h: inverse transforms for the fixed MC6847 lengths with every loop bound,
+//stride and twiddle table known at compile time. Rebuilt by make when this file changes.
+//Usage: fft_codelet_gen > fft_codelets.h
+
+#include <stdio.h>
+#include <math.h>
+
+#define PI 3.14159265358979323846
+
+const unsigned int codelet_lengths[] = {256, 192, 128, 96};
+#define NUM_CODELETS (sizeof(codelet_lengths) / sizeof(codelet_lengths[0]))
+
+//same stage order as the radix 4 plans in fft.c: 4s, then 2, then odd primes ascending
+unsigned int factorize(unsigned int num_points, unsigned int* factors)
+{
+	unsigned int num_factors = 0;
+	while((num_points % 4) == 0)
+	{
+		factors[num_factors++] = 4;
+		num_points = num_points / 4;
+	}
+	if((num_points % 2) == 0)
+	{
+		factors[num_factors++] = 2;
+		num_points = num_points / 2;
+	}
+	for(unsigned int p = 3; num_points > 1; p = p + 2)
+	{
+		while((num_points % p) == 0)
+		{
+			factors[num_factors++] = p;
+			num_points = num_points / p;
+		}
+	}
+	return num_factors;
+}
+
+//index k + s * (q_mul * q + offset) with the terms that are zero left out
+void format_index(char* buffer, unsigned int s, unsigned int m, unsigned int q_mul, unsigned int offset)
+{
+	int length = 0;
+	if(s > 1)
+		length += sprintf(buffer + length, "k");
+	if(m > 1 && s * q_mul == 1)
+		length += sprintf(buffer + length, "%sq", length ? " + " : "");
+	else if(m > 1)
+		length += sprintf(buffer + length, "%s%u * q", length ? " + " : "", s * q_mul);
+	if(offset || !length)
+		length += sprintf(buffer + length, "%s%u", length ? " + " : "", s * offset);
+}
+
+//twiddled output j of the butterfly, the last stage has m == 1 and all its twiddles are 1
+void print_output(const char* indent, const char* dst, char out[][32], unsigned int j, const char* value, unsigned int m)
+{
+	if(j == 0 || m == 1)
+		printf("%s%s[%s] = %s;\n", indent, dst, out[j], value);
+	else
+		printf("%s%s[%s] = cmul(%s, w%u);\n", indent, dst, out[j], value, j);
+}
+
+void print_butterfly(const char* indent, unsigned int p, unsigned int m, unsigned int s, const char* src, const char* dst)
+{
+	char in[5][32];
+	char out[5][32];
+	for(unsigned int j = 0; j < p; ++j)
+	{
+		format_index(in[j], s, m, 1, j * m);
+		format_index(out[j], s, m, p, j);
+		printf("%sfloat complex a%u = %s[%s];\n", indent, j, src, in[j]);
+	}
+	switch(p)
+	{
+		case 2:
+			print_output(indent, dst, out, 0, "a0 + a1", m);
+			print_output(indent, dst, out, 1, "a0 - a1", m);
+			break;
+		case 3:
+			printf("%sfloat complex t = a1 + a2;\n", indent);
+			printf("%sfloat complex mid = a0 - 0.5f * t;\n", indent);
+			printf("%sfloat complex d = half_sqrt3 * rot(a1 - a2, FFT_INVERSE);\n", indent);
+			print_output(indent, dst, out, 0, "a0 + t", m);
+			print_output(indent, dst, out, 1, "mid + d", m);
+			print_output(indent, dst, out, 2, "mid - d", m);
+			break;
+		case 4:
+			printf("%sfloat complex t0 = a0 + a2;\n", indent);
+			printf("%sfloat complex t1 = a0 - a2;\n", indent);
+			printf("%sfloat complex t2 = a1 + a3;\n", indent);
+			printf("%sfloat complex t3 = rot(a1 - a3, FFT_INVERSE);\n", indent);
+			print_output(indent, dst, out, 0, "t0 + t2", m);
+			print_output(indent, dst, out, 1, "t1 + t3", m);
+			print_output(indent, dst, out, 2, "t0 - t2", m);
+			print_output(indent, dst, out, 3, "t1 - t3", m);
+			break;
+	}
+}
+
+void print_codelet(unsigned int num_points)
+{
+	unsigned int factors[32];
+	unsigned int num_factors = factorize(num_points, factors);
+
+	//twiddle tables, w_n^(j*q) = table[q * (p - 1) + j - 1] as in fft_plan_mixed_radix()
+	unsigned int n = num_points;
+	for(unsigned int f = 0; f < num_factors; ++f)
+	{
+		unsigned int p = factors[f];
+		unsigned int m = n / p;
+		if(m > 1)
+		{
+			printf("static const float fft_codelet_twiddles_%u_%u[%u][2] =\n{\n", num_points, f, (p - 1) * m);
+			for(unsigned int q = 0; q < m; ++q)
+			{
+				printf("\t");
+				for(unsigned int j = 1; j < p; ++j)
+				{
+					double angle = 2.0 * PI * (double)(j * q) / (double)n;
+					printf("{%.9ef, %.9ef}%s", (float)cos(angle), (float)sin(angle), (j + 1 < p) ? ", " : "");
+				}
+				printf(",\n");
+			}
+			printf("};\n\n");
+		}
+		n = m;
+	}
+
+	printf("//inverse length %u:", num_points);
+	for(unsigned int f = 0; f < num_factors; ++f)
+		printf(" %u", factors[f]);
+	printf("\nstatic void fft_codelet_inverse_%u(const float complex* input, float complex* output)\n{\n", num_points);
+	printf("\tfloat complex scratch[%u];\n", num_points);
+	for(unsigned int f = 0; f < num_factors; ++f)
+	{
+		if(factors[f] == 3)
+		{
+			printf("\tconst float half_sqrt3 = 0.86602540378443864676;\n");
+			break;
+		}
+	}
+
+	//ping-pong between output and scratch so that the last stage lands in output, like fft_execute()
+	const char* buffers[2];
+	buffers[0] = (num_factors & 1) ? "output" : "scratch";
+	buffers[1] = (num_factors & 1) ? "scratch" : "output";
+	const char* src = "input";
+	n = num_points;
+	unsigned int s = 1;
+	for(unsigned int f = 0; f < num_factors; ++f)
+	{
+		unsigned int p = factors[f];
+		unsigned int m = n / p;
+		const char* dst = buffers[f & 1];
+		printf("\t//radix %u, m = %u, s = %u\n", p, m, s);
+		if(m > 1)
+		{
+			printf("\tfor(unsigned int q = 0; q < %u; ++q)\n\t{\n", m);
+			for(unsigned int j = 1; j < p; ++j)
+			{
+				char row[32];
+				format_index(row, 1, m, p - 1, j - 1);
+				printf("\t\tfloat complex w%u = fft_codelet_twiddles_%u_%u[%s][0] + I * fft_codelet_twiddles_%u_%u[%s][1];\n", j, num_points, f, row, num_points, f, row);
+			}
+			if(s > 1)
+			{
+				printf("\t\tfor(unsigned int k = 0; k < %u; ++k)\n\t\t{\n", s);
+				print_butterfly("\t\t\t", p, m, s, src, dst);
+				printf("\t\t}\n");
+			}
+			else
+			{
+				print_butterfly("\t\t", p, m, s, src, dst);
+			}
+			printf("\t}\n");
+		}
+		else
+		{
+			printf("\tfor(unsigned int k = 0; k < %u; ++k)\n\t{\n", s);
+			print_butterfly("\t\t", p, m, s, src, dst);
+			printf("\t}\n");
+		}
+		src = dst;
+		n = m;
+		s = s * p;
+	}
+	printf("}\n\n");
+}
+
+int main(void)
+{
+	printf("//Generated by fft_codelet_gen.c, do not edit. Included by fft.c only.\n\n");
+	for(unsigned int c = 0; c < NUM_CODELETS; ++c)
+	{
+		print_codelet(codelet_lengths[c]);
+	}
+	printf("typedef void (*fft_codelet)(const float complex* input, float complex* output);\n\n");
+	printf("static fft_codelet fft_codelet_inverse(unsigned int num_points)\n{\n\tswitch(num_points)\n\t{\n");
+	for(unsigned int c = 0; c < NUM_CODELETS; ++c)
+	{
+		printf("\t\tcase %u:\n\t\t\treturn fft_codelet_inverse_%u;\n", codelet_lengths[c], codelet_lengths[c]);
+	}
+	printf("\t\tdefault:\n\t\t\treturn NULL;\n\t}\n}\n");
+	return 0;
+}
@@ -0,0 +1,608 @@
+//Generated by fft_codelet_gen.c, do not edit. Included by fft.c only.
+
+static const float fft_codelet_twiddles_256_0[192][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.996988177e-01f, 2.454122901e-02f}, {9.987954497e-01f, 4.906767607e-02f}, {9.972904325e-01f, 7.356456667e-02f},
+	{9.987954497e-01f, 4.906767607e-02f}, {9.951847196e-01f, 9.801714122e-02f}, {9.891765118e-01f, 1.467304677e-01f},
+	{9.972904325e-01f, 7.356456667e-02f}, {9.891765118e-01f, 1.467304677e-01f}, {9.757021070e-01f, 2.191012353e-01f},
+	{9.951847196e-01f, 9.801714122e-02f}, {9.807852507e-01f, 1.950903237e-01f}, {9.569403529e-01f, 2.902846634e-01f},
+	{9.924795628e-01f, 1.224106774e-01f}, {9.700312614e-01f, 2.429801822e-01f}, {9.329928160e-01f, 3.598950505e-01f},
+	{9.891765118e-01f, 1.467304677e-01f}, {9.569403529e-01f, 2.902846634e-01f}, {9.039893150e-01f, 4.275550842e-01f},
+	{9.852776527e-01f, 1.709618866e-01f}, {9.415440559e-01f, 3.368898630e-01f}, {8.700869679e-01f, 4.928981960e-01f},
+	{9.807852507e-01f, 1.950903237e-01f}, {9.238795042e-01f, 3.826834261e-01f}, {8.314695954e-01f, 5.555702448e-01f},
+	{9.757021070e-01f, 2.191012353e-01f}, {9.039893150e-01f, 4.275550842e-01f}, {7.883464098e-01f, 6.152315736e-01f},
+	{9.700312614e-01f, 2.429801822e-01f}, {8.819212914e-01f, 4.713967443e-01f}, {7.409511209e-01f, 6.715589762e-01f},
+	{9.637760520e-01f, 2.667127550e-01f}, {8.577286005e-01f, 5.141027570e-01f}, {6.895405650e-01f, 7.242470980e-01f},
+	{9.569403529e-01f, 2.902846634e-01f}, {8.314695954e-01f, 5.555702448e-01f}, {6.343932748e-01f, 7.730104327e-01f},
+	{9.495281577e-01f, 3.136817515e-01f}, {8.032075167e-01f, 5.956993103e-01f}, {5.758081675e-01f, 8.175848126e-01f},
+	{9.415440559e-01f, 3.368898630e-01f}, {7.730104327e-01f, 6.343932748e-01f}, {5.141027570e-01f, 8.577286005e-01f},
+	{9.329928160e-01f, 3.598950505e-01f}, {7.409511209e-01f, 6.715589762e-01f}, {4.496113360e-01f, 8.932242990e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{9.142097831e-01f, 4.052413106e-01f}, {6.715589762e-01f, 7.409511209e-01f}, {3.136817515e-01f, 9.495281577e-01f},
+	{9.039893150e-01f, 4.275550842e-01f}, {6.343932748e-01f, 7.730104327e-01f}, {2.429801822e-01f, 9.700312614e-01f},
+	{8.932242990e-01f, 4.496113360e-01f}, {5.956993103e-01f, 8.032075167e-01f}, {1.709618866e-01f, 9.852776527e-01f},
+	{8.819212914e-01f, 4.713967443e-01f}, {5.555702448e-01f, 8.314695954e-01f}, {9.801714122e-02f, 9.951847196e-01f},
+	{8.700869679e-01f, 4.928981960e-01f}, {5.141027570e-01f, 8.577286005e-01f}, {2.454122901e-02f, 9.996988177e-01f},
+	{8.577286005e-01f, 5.141027570e-01f}, {4.713967443e-01f, 8.819212914e-01f}, {-4.906767607e-02f, 9.987954497e-01f},
+	{8.448535800e-01f, 5.349976420e-01f}, {4.275550842e-01f, 9.039893150e-01f}, {-1.224106774e-01f, 9.924795628e-01f},
+	{8.314695954e-01f, 5.555702448e-01f}, {3.826834261e-01f, 9.238795042e-01f}, {-1.950903237e-01f, 9.807852507e-01f},
+	{8.175848126e-01f, 5.758081675e-01f}, {3.368898630e-01f, 9.415440559e-01f}, {-2.667127550e-01f, 9.637760520e-01f},
+	{8.032075167e-01f, 5.956993103e-01f}, {2.902846634e-01f, 9.569403529e-01f}, {-3.368898630e-01f, 9.415440559e-01f},
+	{7.883464098e-01f, 6.152315736e-01f}, {2.429801822e-01f, 9.700312614e-01f}, {-4.052413106e-01f, 9.142097831e-01f},
+	{7.730104327e-01f, 6.343932748e-01f}, {1.950903237e-01f, 9.807852507e-01f}, {-4.713967443e-01f, 8.819212914e-01f},
+	{7.572088242e-01f, 6.531728506e-01f}, {1.467304677e-01f, 9.891765118e-01f}, {-5.349976420e-01f, 8.448535800e-01f},
+	{7.409511209e-01f, 6.715589762e-01f}, {9.801714122e-02f, 9.951847196e-01f}, {-5.956993103e-01f, 8.032075167e-01f},
+	{7.242470980e-01f, 6.895405650e-01f}, {4.906767607e-02f, 9.987954497e-01f}, {-6.531728506e-01f, 7.572088242e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{6.895405650e-01f, 7.242470980e-01f}, {-4.906767607e-02f, 9.987954497e-01f}, {-7.572088242e-01f, 6.531728506e-01f},
+	{6.715589762e-01f, 7.409511209e-01f}, {-9.801714122e-02f, 9.951847196e-01f}, {-8.032075167e-01f, 5.956993103e-01f},
+	{6.531728506e-01f, 7.572088242e-01f}, {-1.467304677e-01f, 9.891765118e-01f}, {-8.448535800e-01f, 5.349976420e-01f},
+	{6.343932748e-01f, 7.730104327e-01f}, {-1.950903237e-01f, 9.807852507e-01f}, {-8.819212914e-01f, 4.713967443e-01f},
+	{6.152315736e-01f, 7.883464098e-01f}, {-2.429801822e-01f, 9.700312614e-01f}, {-9.142097831e-01f, 4.052413106e-01f},
+	{5.956993103e-01f, 8.032075167e-01f}, {-2.902846634e-01f, 9.569403529e-01f}, {-9.415440559e-01f, 3.368898630e-01f},
+	{5.758081675e-01f, 8.175848126e-01f}, {-3.368898630e-01f, 9.415440559e-01f}, {-9.637760520e-01f, 2.667127550e-01f},
+	{5.555702448e-01f, 8.314695954e-01f}, {-3.826834261e-01f, 9.238795042e-01f}, {-9.807852507e-01f, 1.950903237e-01f},
+	{5.349976420e-01f, 8.448535800e-01f}, {-4.275550842e-01f, 9.039893150e-01f}, {-9.924795628e-01f, 1.224106774e-01f},
+	{5.141027570e-01f, 8.577286005e-01f}, {-4.713967443e-01f, 8.819212914e-01f}, {-9.987954497e-01f, 4.906767607e-02f},
+	{4.928981960e-01f, 8.700869679e-01f}, {-5.141027570e-01f, 8.577286005e-01f}, {-9.996988177e-01f, -2.454122901e-02f},
+	{4.713967443e-01f, 8.819212914e-01f}, {-5.555702448e-01f, 8.314695954e-01f}, {-9.951847196e-01f, -9.801714122e-02f},
+	{4.496113360e-01f, 8.932242990e-01f}, {-5.956993103e-01f, 8.032075167e-01f}, {-9.852776527e-01f, -1.709618866e-01f},
+	{4.275550842e-01f, 9.039893150e-01f}, {-6.343932748e-01f, 7.730104327e-01f}, {-9.700312614e-01f, -2.429801822e-01f},
+	{4.052413106e-01f, 9.142097831e-01f}, {-6.715589762e-01f, 7.409511209e-01f}, {-9.495281577e-01f, -3.136817515e-01f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{3.598950505e-01f, 9.329928160e-01f}, {-7.409511209e-01f, 6.715589762e-01f}, {-8.932242990e-01f, -4.496113360e-01f},
+	{3.368898630e-01f, 9.415440559e-01f}, {-7.730104327e-01f, 6.343932748e-01f}, {-8.577286005e-01f, -5.141027570e-01f},
+	{3.136817515e-01f, 9.495281577e-01f}, {-8.032075167e-01f, 5.956993103e-01f}, {-8.175848126e-01f, -5.758081675e-01f},
+	{2.902846634e-01f, 9.569403529e-01f}, {-8.314695954e-01f, 5.555702448e-01f}, {-7.730104327e-01f, -6.343932748e-01f},
+	{2.667127550e-01f, 9.637760520e-01f}, {-8.577286005e-01f, 5.141027570e-01f}, {-7.242470980e-01f, -6.895405650e-01f},
+	{2.429801822e-01f, 9.700312614e-01f}, {-8.819212914e-01f, 4.713967443e-01f}, {-6.715589762e-01f, -7.409511209e-01f},
+	{2.191012353e-01f, 9.757021070e-01f}, {-9.039893150e-01f, 4.275550842e-01f}, {-6.152315736e-01f, -7.883464098e-01f},
+	{1.950903237e-01f, 9.807852507e-01f}, {-9.238795042e-01f, 3.826834261e-01f}, {-5.555702448e-01f, -8.314695954e-01f},
+	{1.709618866e-01f, 9.852776527e-01f}, {-9.415440559e-01f, 3.368898630e-01f}, {-4.928981960e-01f, -8.700869679e-01f},
+	{1.467304677e-01f, 9.891765118e-01f}, {-9.569403529e-01f, 2.902846634e-01f}, {-4.275550842e-01f, -9.039893150e-01f},
+	{1.224106774e-01f, 9.924795628e-01f}, {-9.700312614e-01f, 2.429801822e-01f}, {-3.598950505e-01f, -9.329928160e-01f},
+	{9.801714122e-02f, 9.951847196e-01f}, {-9.807852507e-01f, 1.950903237e-01f}, {-2.902846634e-01f, -9.569403529e-01f},
+	{7.356456667e-02f, 9.972904325e-01f}, {-9.891765118e-01f, 1.467304677e-01f}, {-2.191012353e-01f, -9.757021070e-01f},
+	{4.906767607e-02f, 9.987954497e-01f}, {-9.951847196e-01f, 9.801714122e-02f}, {-1.467304677e-01f, -9.891765118e-01f},
+	{2.454122901e-02f, 9.996988177e-01f}, {-9.987954497e-01f, 4.906767607e-02f}, {-7.356456667e-02f, -9.972904325e-01f},
+};
+
+static const float fft_codelet_twiddles_256_1[48][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.951847196e-01f, 9.801714122e-02f}, {9.807852507e-01f, 1.950903237e-01f}, {9.569403529e-01f, 2.902846634e-01f},
+	{9.807852507e-01f, 1.950903237e-01f}, {9.238795042e-01f, 3.826834261e-01f}, {8.314695954e-01f, 5.555702448e-01f},
+	{9.569403529e-01f, 2.902846634e-01f}, {8.314695954e-01f, 5.555702448e-01f}, {6.343932748e-01f, 7.730104327e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{8.819212914e-01f, 4.713967443e-01f}, {5.555702448e-01f, 8.314695954e-01f}, {9.801714122e-02f, 9.951847196e-01f},
+	{8.314695954e-01f, 5.555702448e-01f}, {3.826834261e-01f, 9.238795042e-01f}, {-1.950903237e-01f, 9.807852507e-01f},
+	{7.730104327e-01f, 6.343932748e-01f}, {1.950903237e-01f, 9.807852507e-01f}, {-4.713967443e-01f, 8.819212914e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{6.343932748e-01f, 7.730104327e-01f}, {-1.950903237e-01f, 9.807852507e-01f}, {-8.819212914e-01f, 4.713967443e-01f},
+	{5.555702448e-01f, 8.314695954e-01f}, {-3.826834261e-01f, 9.238795042e-01f}, {-9.807852507e-01f, 1.950903237e-01f},
+	{4.713967443e-01f, 8.819212914e-01f}, {-5.555702448e-01f, 8.314695954e-01f}, {-9.951847196e-01f, -9.801714122e-02f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{2.902846634e-01f, 9.569403529e-01f}, {-8.314695954e-01f, 5.555702448e-01f}, {-7.730104327e-01f, -6.343932748e-01f},
+	{1.950903237e-01f, 9.807852507e-01f}, {-9.238795042e-01f, 3.826834261e-01f}, {-5.555702448e-01f, -8.314695954e-01f},
+	{9.801714122e-02f, 9.951847196e-01f}, {-9.807852507e-01f, 1.950903237e-01f}, {-2.902846634e-01f, -9.569403529e-01f},
+};
+
+static const float fft_codelet_twiddles_256_2[12][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+};
+
+//inverse length 256: 4 4 4 4
+static void fft_codelet_inverse_256(const float complex* input, float complex* output)
+{
+	float complex scratch[256];
+	//radix 4, m = 64, s = 1
+	for(unsigned int q = 0; q < 64; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_256_0[3 * q][0] + I * fft_codelet_twiddles_256_0[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_256_0[3 * q + 1][0] + I * fft_codelet_twiddles_256_0[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_256_0[3 * q + 2][0] + I * fft_codelet_twiddles_256_0[3 * q + 2][1];
+		float complex a0 = input[q];
+		float complex a1 = input[q + 64];
+		float complex a2 = input[q + 128];
+		float complex a3 = input[q + 192];
+		float complex t0 = a0 + a2;
+		float complex t1 = a0 - a2;
+		float complex t2 = a1 + a3;
+		float complex t3 = rot(a1 - a3, FFT_INVERSE);
+		scratch[4 * q] = t0 + t2;
+		scratch[4 * q + 1] = cmul(t1 + t3, w1);
+		scratch[4 * q + 2] = cmul(t0 - t2, w2);
+		scratch[4 * q + 3] = cmul(t1 - t3, w3);
+	}
+	//radix 4, m = 16, s = 4
+	for(unsigned int q = 0; q < 16; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_256_1[3 * q][0] + I * fft_codelet_twiddles_256_1[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_256_1[3 * q + 1][0] + I * fft_codelet_twiddles_256_1[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_256_1[3 * q + 2][0] + I * fft_codelet_twiddles_256_1[3 * q + 2][1];
+		for(unsigned int k = 0; k < 4; ++k)
+		{
+			float complex a0 = scratch[k + 4 * q];
+			float complex a1 = scratch[k + 4 * q + 64];
+			float complex a2 = scratch[k + 4 * q + 128];
+			float complex a3 = scratch[k + 4 * q + 192];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			output[k + 16 * q] = t0 + t2;
+			output[k + 16 * q + 4] = cmul(t1 + t3, w1);
+			output[k + 16 * q + 8] = cmul(t0 - t2, w2);
+			output[k + 16 * q + 12] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 4, m = 4, s = 16
+	for(unsigned int q = 0; q < 4; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_256_2[3 * q][0] + I * fft_codelet_twiddles_256_2[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_256_2[3 * q + 1][0] + I * fft_codelet_twiddles_256_2[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_256_2[3 * q + 2][0] + I * fft_codelet_twiddles_256_2[3 * q + 2][1];
+		for(unsigned int k = 0; k < 16; ++k)
+		{
+			float complex a0 = output[k + 16 * q];
+			float complex a1 = output[k + 16 * q + 64];
+			float complex a2 = output[k + 16 * q + 128];
+			float complex a3 = output[k + 16 * q + 192];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			scratch[k + 64 * q] = t0 + t2;
+			scratch[k + 64 * q + 16] = cmul(t1 + t3, w1);
+			scratch[k + 64 * q + 32] = cmul(t0 - t2, w2);
+			scratch[k + 64 * q + 48] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 4, m = 1, s = 64
+	for(unsigned int k = 0; k < 64; ++k)
+	{
+		float complex a0 = scratch[k];
+		float complex a1 = scratch[k + 64];
+		float complex a2 = scratch[k + 128];
+		float complex a3 = scratch[k + 192];
+		float complex t0 = a0 + a2;
+		float complex t1 = a0 - a2;
+		float complex t2 = a1 + a3;
+		float complex t3 = rot(a1 - a3, FFT_INVERSE);
+		output[k] = t0 + t2;
+		output[k + 64] = t1 + t3;
+		output[k + 128] = t0 - t2;
+		output[k + 192] = t1 - t3;
+	}
+}
+
+static const float fft_codelet_twiddles_192_0[144][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.994645715e-01f, 3.271908313e-02f}, {9.978589416e-01f, 6.540312618e-02f}, {9.951847196e-01f, 9.801714122e-02f},
+	{9.978589416e-01f, 6.540312618e-02f}, {9.914448857e-01f, 1.305261850e-01f}, {9.807852507e-01f, 1.950903237e-01f},
+	{9.951847196e-01f, 9.801714122e-02f}, {9.807852507e-01f, 1.950903237e-01f}, {9.569403529e-01f, 2.902846634e-01f},
+	{9.914448857e-01f, 1.305261850e-01f}, {9.659258127e-01f, 2.588190436e-01f}, {9.238795042e-01f, 3.826834261e-01f},
+	{9.866433144e-01f, 1.628954709e-01f}, {9.469301105e-01f, 3.214394748e-01f}, {8.819212914e-01f, 4.713967443e-01f},
+	{9.807852507e-01f, 1.950903237e-01f}, {9.238795042e-01f, 3.826834261e-01f}, {8.314695954e-01f, 5.555702448e-01f},
+	{9.738769531e-01f, 2.270762622e-01f}, {8.968727589e-01f, 4.422886968e-01f}, {7.730104327e-01f, 6.343932748e-01f},
+	{9.659258127e-01f, 2.588190436e-01f}, {8.660253882e-01f, 5.000000000e-01f}, {7.071067691e-01f, 7.071067691e-01f},
+	{9.569403529e-01f, 2.902846634e-01f}, {8.314695954e-01f, 5.555702448e-01f}, {6.343932748e-01f, 7.730104327e-01f},
+	{9.469301105e-01f, 3.214394748e-01f}, {7.933533192e-01f, 6.087614298e-01f}, {5.555702448e-01f, 8.314695954e-01f},
+	{9.359059334e-01f, 3.522500396e-01f}, {7.518398166e-01f, 6.593458056e-01f}, {4.713967443e-01f, 8.819212914e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{9.108638167e-01f, 4.127070308e-01f}, {6.593458056e-01f, 7.518398166e-01f}, {2.902846634e-01f, 9.569403529e-01f},
+	{8.968727589e-01f, 4.422886968e-01f}, {6.087614298e-01f, 7.933533192e-01f}, {1.950903237e-01f, 9.807852507e-01f},
+	{8.819212914e-01f, 4.713967443e-01f}, {5.555702448e-01f, 8.314695954e-01f}, {9.801714122e-02f, 9.951847196e-01f},
+	{8.660253882e-01f, 5.000000000e-01f}, {5.000000000e-01f, 8.660253882e-01f}, {6.123234263e-17f, 1.000000000e+00f},
+	{8.492021561e-01f, 5.280678272e-01f}, {4.422886968e-01f, 8.968727589e-01f}, {-9.801714122e-02f, 9.951847196e-01f},
+	{8.314695954e-01f, 5.555702448e-01f}, {3.826834261e-01f, 9.238795042e-01f}, {-1.950903237e-01f, 9.807852507e-01f},
+	{8.128466606e-01f, 5.824776888e-01f}, {3.214394748e-01f, 9.469301105e-01f}, {-2.902846634e-01f, 9.569403529e-01f},
+	{7.933533192e-01f, 6.087614298e-01f}, {2.588190436e-01f, 9.659258127e-01f}, {-3.826834261e-01f, 9.238795042e-01f},
+	{7.730104327e-01f, 6.343932748e-01f}, {1.950903237e-01f, 9.807852507e-01f}, {-4.713967443e-01f, 8.819212914e-01f},
+	{7.518398166e-01f, 6.593458056e-01f}, {1.305261850e-01f, 9.914448857e-01f}, {-5.555702448e-01f, 8.314695954e-01f},
+	{7.298640609e-01f, 6.835923195e-01f}, {6.540312618e-02f, 9.978589416e-01f}, {-6.343932748e-01f, 7.730104327e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{6.835923195e-01f, 7.298640609e-01f}, {-6.540312618e-02f, 9.978589416e-01f}, {-7.730104327e-01f, 6.343932748e-01f},
+	{6.593458056e-01f, 7.518398166e-01f}, {-1.305261850e-01f, 9.914448857e-01f}, {-8.314695954e-01f, 5.555702448e-01f},
+	{6.343932748e-01f, 7.730104327e-01f}, {-1.950903237e-01f, 9.807852507e-01f}, {-8.819212914e-01f, 4.713967443e-01f},
+	{6.087614298e-01f, 7.933533192e-01f}, {-2.588190436e-01f, 9.659258127e-01f}, {-9.238795042e-01f, 3.826834261e-01f},
+	{5.824776888e-01f, 8.128466606e-01f}, {-3.214394748e-01f, 9.469301105e-01f}, {-9.569403529e-01f, 2.902846634e-01f},
+	{5.555702448e-01f, 8.314695954e-01f}, {-3.826834261e-01f, 9.238795042e-01f}, {-9.807852507e-01f, 1.950903237e-01f},
+	{5.280678272e-01f, 8.492021561e-01f}, {-4.422886968e-01f, 8.968727589e-01f}, {-9.951847196e-01f, 9.801714122e-02f},
+	{5.000000000e-01f, 8.660253882e-01f}, {-5.000000000e-01f, 8.660253882e-01f}, {-1.000000000e+00f, 1.224646853e-16f},
+	{4.713967443e-01f, 8.819212914e-01f}, {-5.555702448e-01f, 8.314695954e-01f}, {-9.951847196e-01f, -9.801714122e-02f},
+	{4.422886968e-01f, 8.968727589e-01f}, {-6.087614298e-01f, 7.933533192e-01f}, {-9.807852507e-01f, -1.950903237e-01f},
+	{4.127070308e-01f, 9.108638167e-01f}, {-6.593458056e-01f, 7.518398166e-01f}, {-9.569403529e-01f, -2.902846634e-01f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{3.522500396e-01f, 9.359059334e-01f}, {-7.518398166e-01f, 6.593458056e-01f}, {-8.819212914e-01f, -4.713967443e-01f},
+	{3.214394748e-01f, 9.469301105e-01f}, {-7.933533192e-01f, 6.087614298e-01f}, {-8.314695954e-01f, -5.555702448e-01f},
+	{2.902846634e-01f, 9.569403529e-01f}, {-8.314695954e-01f, 5.555702448e-01f}, {-7.730104327e-01f, -6.343932748e-01f},
+	{2.588190436e-01f, 9.659258127e-01f}, {-8.660253882e-01f, 5.000000000e-01f}, {-7.071067691e-01f, -7.071067691e-01f},
+	{2.270762622e-01f, 9.738769531e-01f}, {-8.968727589e-01f, 4.422886968e-01f}, {-6.343932748e-01f, -7.730104327e-01f},
+	{1.950903237e-01f, 9.807852507e-01f}, {-9.238795042e-01f, 3.826834261e-01f}, {-5.555702448e-01f, -8.314695954e-01f},
+	{1.628954709e-01f, 9.866433144e-01f}, {-9.469301105e-01f, 3.214394748e-01f}, {-4.713967443e-01f, -8.819212914e-01f},
+	{1.305261850e-01f, 9.914448857e-01f}, {-9.659258127e-01f, 2.588190436e-01f}, {-3.826834261e-01f, -9.238795042e-01f},
+	{9.801714122e-02f, 9.951847196e-01f}, {-9.807852507e-01f, 1.950903237e-01f}, {-2.902846634e-01f, -9.569403529e-01f},
+	{6.540312618e-02f, 9.978589416e-01f}, {-9.914448857e-01f, 1.305261850e-01f}, {-1.950903237e-01f, -9.807852507e-01f},
+	{3.271908313e-02f, 9.994645715e-01f}, {-9.978589416e-01f, 6.540312618e-02f}, {-9.801714122e-02f, -9.951847196e-01f},
+};
+
+static const float fft_codelet_twiddles_192_1[36][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.914448857e-01f, 1.305261850e-01f}, {9.659258127e-01f, 2.588190436e-01f}, {9.238795042e-01f, 3.826834261e-01f},
+	{9.659258127e-01f, 2.588190436e-01f}, {8.660253882e-01f, 5.000000000e-01f}, {7.071067691e-01f, 7.071067691e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{8.660253882e-01f, 5.000000000e-01f}, {5.000000000e-01f, 8.660253882e-01f}, {6.123234263e-17f, 1.000000000e+00f},
+	{7.933533192e-01f, 6.087614298e-01f}, {2.588190436e-01f, 9.659258127e-01f}, {-3.826834261e-01f, 9.238795042e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{6.087614298e-01f, 7.933533192e-01f}, {-2.588190436e-01f, 9.659258127e-01f}, {-9.238795042e-01f, 3.826834261e-01f},
+	{5.000000000e-01f, 8.660253882e-01f}, {-5.000000000e-01f, 8.660253882e-01f}, {-1.000000000e+00f, 1.224646853e-16f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{2.588190436e-01f, 9.659258127e-01f}, {-8.660253882e-01f, 5.000000000e-01f}, {-7.071067691e-01f, -7.071067691e-01f},
+	{1.305261850e-01f, 9.914448857e-01f}, {-9.659258127e-01f, 2.588190436e-01f}, {-3.826834261e-01f, -9.238795042e-01f},
+};
+
+static const float fft_codelet_twiddles_192_2[9][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{8.660253882e-01f, 5.000000000e-01f}, {5.000000000e-01f, 8.660253882e-01f}, {6.123234263e-17f, 1.000000000e+00f},
+	{5.000000000e-01f, 8.660253882e-01f}, {-5.000000000e-01f, 8.660253882e-01f}, {-1.000000000e+00f, 1.224646853e-16f},
+};
+
+//inverse length 192: 4 4 4 3
+static void fft_codelet_inverse_192(const float complex* input, float complex* output)
+{
+	float complex scratch[192];
+	const float half_sqrt3 = 0.86602540378443864676;
+	//radix 4, m = 48, s = 1
+	for(unsigned int q = 0; q < 48; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_192_0[3 * q][0] + I * fft_codelet_twiddles_192_0[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_192_0[3 * q + 1][0] + I * fft_codelet_twiddles_192_0[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_192_0[3 * q + 2][0] + I * fft_codelet_twiddles_192_0[3 * q + 2][1];
+		float complex a0 = input[q];
+		float complex a1 = input[q + 48];
+		float complex a2 = input[q + 96];
+		float complex a3 = input[q + 144];
+		float complex t0 = a0 + a2;
+		float complex t1 = a0 - a2;
+		float complex t2 = a1 + a3;
+		float complex t3 = rot(a1 - a3, FFT_INVERSE);
+		scratch[4 * q] = t0 + t2;
+		scratch[4 * q + 1] = cmul(t1 + t3, w1);
+		scratch[4 * q + 2] = cmul(t0 - t2, w2);
+		scratch[4 * q + 3] = cmul(t1 - t3, w3);
+	}
+	//radix 4, m = 12, s = 4
+	for(unsigned int q = 0; q < 12; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_192_1[3 * q][0] + I * fft_codelet_twiddles_192_1[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_192_1[3 * q + 1][0] + I * fft_codelet_twiddles_192_1[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_192_1[3 * q + 2][0] + I * fft_codelet_twiddles_192_1[3 * q + 2][1];
+		for(unsigned int k = 0; k < 4; ++k)
+		{
+			float complex a0 = scratch[k + 4 * q];
+			float complex a1 = scratch[k + 4 * q + 48];
+			float complex a2 = scratch[k + 4 * q + 96];
+			float complex a3 = scratch[k + 4 * q + 144];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			output[k + 16 * q] = t0 + t2;
+			output[k + 16 * q + 4] = cmul(t1 + t3, w1);
+			output[k + 16 * q + 8] = cmul(t0 - t2, w2);
+			output[k + 16 * q + 12] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 4, m = 3, s = 16
+	for(unsigned int q = 0; q < 3; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_192_2[3 * q][0] + I * fft_codelet_twiddles_192_2[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_192_2[3 * q + 1][0] + I * fft_codelet_twiddles_192_2[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_192_2[3 * q + 2][0] + I * fft_codelet_twiddles_192_2[3 * q + 2][1];
+		for(unsigned int k = 0; k < 16; ++k)
+		{
+			float complex a0 = output[k + 16 * q];
+			float complex a1 = output[k + 16 * q + 48];
+			float complex a2 = output[k + 16 * q + 96];
+			float complex a3 = output[k + 16 * q + 144];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			scratch[k + 64 * q] = t0 + t2;
+			scratch[k + 64 * q + 16] = cmul(t1 + t3, w1);
+			scratch[k + 64 * q + 32] = cmul(t0 - t2, w2);
+			scratch[k + 64 * q + 48] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 3, m = 1, s = 64
+	for(unsigned int k = 0; k < 64; ++k)
+	{
+		float complex a0 = scratch[k];
+		float complex a1 = scratch[k + 64];
+		float complex a2 = scratch[k + 128];
+		float complex t = a1 + a2;
+		float complex mid = a0 - 0.5f * t;
+		float complex d = half_sqrt3 * rot(a1 - a2, FFT_INVERSE);
+		output[k] = a0 + t;
+		output[k + 64] = mid + d;
+		output[k + 128] = mid - d;
+	}
+}
+
+static const float fft_codelet_twiddles_128_0[96][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.987954497e-01f, 4.906767607e-02f}, {9.951847196e-01f, 9.801714122e-02f}, {9.891765118e-01f, 1.467304677e-01f},
+	{9.951847196e-01f, 9.801714122e-02f}, {9.807852507e-01f, 1.950903237e-01f}, {9.569403529e-01f, 2.902846634e-01f},
+	{9.891765118e-01f, 1.467304677e-01f}, {9.569403529e-01f, 2.902846634e-01f}, {9.039893150e-01f, 4.275550842e-01f},
+	{9.807852507e-01f, 1.950903237e-01f}, {9.238795042e-01f, 3.826834261e-01f}, {8.314695954e-01f, 5.555702448e-01f},
+	{9.700312614e-01f, 2.429801822e-01f}, {8.819212914e-01f, 4.713967443e-01f}, {7.409511209e-01f, 6.715589762e-01f},
+	{9.569403529e-01f, 2.902846634e-01f}, {8.314695954e-01f, 5.555702448e-01f}, {6.343932748e-01f, 7.730104327e-01f},
+	{9.415440559e-01f, 3.368898630e-01f}, {7.730104327e-01f, 6.343932748e-01f}, {5.141027570e-01f, 8.577286005e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{9.039893150e-01f, 4.275550842e-01f}, {6.343932748e-01f, 7.730104327e-01f}, {2.429801822e-01f, 9.700312614e-01f},
+	{8.819212914e-01f, 4.713967443e-01f}, {5.555702448e-01f, 8.314695954e-01f}, {9.801714122e-02f, 9.951847196e-01f},
+	{8.577286005e-01f, 5.141027570e-01f}, {4.713967443e-01f, 8.819212914e-01f}, {-4.906767607e-02f, 9.987954497e-01f},
+	{8.314695954e-01f, 5.555702448e-01f}, {3.826834261e-01f, 9.238795042e-01f}, {-1.950903237e-01f, 9.807852507e-01f},
+	{8.032075167e-01f, 5.956993103e-01f}, {2.902846634e-01f, 9.569403529e-01f}, {-3.368898630e-01f, 9.415440559e-01f},
+	{7.730104327e-01f, 6.343932748e-01f}, {1.950903237e-01f, 9.807852507e-01f}, {-4.713967443e-01f, 8.819212914e-01f},
+	{7.409511209e-01f, 6.715589762e-01f}, {9.801714122e-02f, 9.951847196e-01f}, {-5.956993103e-01f, 8.032075167e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{6.715589762e-01f, 7.409511209e-01f}, {-9.801714122e-02f, 9.951847196e-01f}, {-8.032075167e-01f, 5.956993103e-01f},
+	{6.343932748e-01f, 7.730104327e-01f}, {-1.950903237e-01f, 9.807852507e-01f}, {-8.819212914e-01f, 4.713967443e-01f},
+	{5.956993103e-01f, 8.032075167e-01f}, {-2.902846634e-01f, 9.569403529e-01f}, {-9.415440559e-01f, 3.368898630e-01f},
+	{5.555702448e-01f, 8.314695954e-01f}, {-3.826834261e-01f, 9.238795042e-01f}, {-9.807852507e-01f, 1.950903237e-01f},
+	{5.141027570e-01f, 8.577286005e-01f}, {-4.713967443e-01f, 8.819212914e-01f}, {-9.987954497e-01f, 4.906767607e-02f},
+	{4.713967443e-01f, 8.819212914e-01f}, {-5.555702448e-01f, 8.314695954e-01f}, {-9.951847196e-01f, -9.801714122e-02f},
+	{4.275550842e-01f, 9.039893150e-01f}, {-6.343932748e-01f, 7.730104327e-01f}, {-9.700312614e-01f, -2.429801822e-01f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{3.368898630e-01f, 9.415440559e-01f}, {-7.730104327e-01f, 6.343932748e-01f}, {-8.577286005e-01f, -5.141027570e-01f},
+	{2.902846634e-01f, 9.569403529e-01f}, {-8.314695954e-01f, 5.555702448e-01f}, {-7.730104327e-01f, -6.343932748e-01f},
+	{2.429801822e-01f, 9.700312614e-01f}, {-8.819212914e-01f, 4.713967443e-01f}, {-6.715589762e-01f, -7.409511209e-01f},
+	{1.950903237e-01f, 9.807852507e-01f}, {-9.238795042e-01f, 3.826834261e-01f}, {-5.555702448e-01f, -8.314695954e-01f},
+	{1.467304677e-01f, 9.891765118e-01f}, {-9.569403529e-01f, 2.902846634e-01f}, {-4.275550842e-01f, -9.039893150e-01f},
+	{9.801714122e-02f, 9.951847196e-01f}, {-9.807852507e-01f, 1.950903237e-01f}, {-2.902846634e-01f, -9.569403529e-01f},
+	{4.906767607e-02f, 9.987954497e-01f}, {-9.951847196e-01f, 9.801714122e-02f}, {-1.467304677e-01f, -9.891765118e-01f},
+};
+
+static const float fft_codelet_twiddles_128_1[24][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.807852507e-01f, 1.950903237e-01f}, {9.238795042e-01f, 3.826834261e-01f}, {8.314695954e-01f, 5.555702448e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{8.314695954e-01f, 5.555702448e-01f}, {3.826834261e-01f, 9.238795042e-01f}, {-1.950903237e-01f, 9.807852507e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{5.555702448e-01f, 8.314695954e-01f}, {-3.826834261e-01f, 9.238795042e-01f}, {-9.807852507e-01f, 1.950903237e-01f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{1.950903237e-01f, 9.807852507e-01f}, {-9.238795042e-01f, 3.826834261e-01f}, {-5.555702448e-01f, -8.314695954e-01f},
+};
+
+static const float fft_codelet_twiddles_128_2[6][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+};
+
+//inverse length 128: 4 4 4 2
+static void fft_codelet_inverse_128(const float complex* input, float complex* output)
+{
+	float complex scratch[128];
+	//radix 4, m = 32, s = 1
+	for(unsigned int q = 0; q < 32; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_128_0[3 * q][0] + I * fft_codelet_twiddles_128_0[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_128_0[3 * q + 1][0] + I * fft_codelet_twiddles_128_0[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_128_0[3 * q + 2][0] + I * fft_codelet_twiddles_128_0[3 * q + 2][1];
+		float complex a0 = input[q];
+		float complex a1 = input[q + 32];
+		float complex a2 = input[q + 64];
+		float complex a3 = input[q + 96];
+		float complex t0 = a0 + a2;
+		float complex t1 = a0 - a2;
+		float complex t2 = a1 + a3;
+		float complex t3 = rot(a1 - a3, FFT_INVERSE);
+		scratch[4 * q] = t0 + t2;
+		scratch[4 * q + 1] = cmul(t1 + t3, w1);
+		scratch[4 * q + 2] = cmul(t0 - t2, w2);
+		scratch[4 * q + 3] = cmul(t1 - t3, w3);
+	}
+	//radix 4, m = 8, s = 4
+	for(unsigned int q = 0; q < 8; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_128_1[3 * q][0] + I * fft_codelet_twiddles_128_1[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_128_1[3 * q + 1][0] + I * fft_codelet_twiddles_128_1[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_128_1[3 * q + 2][0] + I * fft_codelet_twiddles_128_1[3 * q + 2][1];
+		for(unsigned int k = 0; k < 4; ++k)
+		{
+			float complex a0 = scratch[k + 4 * q];
+			float complex a1 = scratch[k + 4 * q + 32];
+			float complex a2 = scratch[k + 4 * q + 64];
+			float complex a3 = scratch[k + 4 * q + 96];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			output[k + 16 * q] = t0 + t2;
+			output[k + 16 * q + 4] = cmul(t1 + t3, w1);
+			output[k + 16 * q + 8] = cmul(t0 - t2, w2);
+			output[k + 16 * q + 12] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 4, m = 2, s = 16
+	for(unsigned int q = 0; q < 2; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_128_2[3 * q][0] + I * fft_codelet_twiddles_128_2[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_128_2[3 * q + 1][0] + I * fft_codelet_twiddles_128_2[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_128_2[3 * q + 2][0] + I * fft_codelet_twiddles_128_2[3 * q + 2][1];
+		for(unsigned int k = 0; k < 16; ++k)
+		{
+			float complex a0 = output[k + 16 * q];
+			float complex a1 = output[k + 16 * q + 32];
+			float complex a2 = output[k + 16 * q + 64];
+			float complex a3 = output[k + 16 * q + 96];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			scratch[k + 64 * q] = t0 + t2;
+			scratch[k + 64 * q + 16] = cmul(t1 + t3, w1);
+			scratch[k + 64 * q + 32] = cmul(t0 - t2, w2);
+			scratch[k + 64 * q + 48] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 2, m = 1, s = 64
+	for(unsigned int k = 0; k < 64; ++k)
+	{
+		float complex a0 = scratch[k];
+		float complex a1 = scratch[k + 64];
+		output[k] = a0 + a1;
+		output[k + 64] = a0 - a1;
+	}
+}
+
+static const float fft_codelet_twiddles_96_0[72][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.978589416e-01f, 6.540312618e-02f}, {9.914448857e-01f, 1.305261850e-01f}, {9.807852507e-01f, 1.950903237e-01f},
+	{9.914448857e-01f, 1.305261850e-01f}, {9.659258127e-01f, 2.588190436e-01f}, {9.238795042e-01f, 3.826834261e-01f},
+	{9.807852507e-01f, 1.950903237e-01f}, {9.238795042e-01f, 3.826834261e-01f}, {8.314695954e-01f, 5.555702448e-01f},
+	{9.659258127e-01f, 2.588190436e-01f}, {8.660253882e-01f, 5.000000000e-01f}, {7.071067691e-01f, 7.071067691e-01f},
+	{9.469301105e-01f, 3.214394748e-01f}, {7.933533192e-01f, 6.087614298e-01f}, {5.555702448e-01f, 8.314695954e-01f},
+	{9.238795042e-01f, 3.826834261e-01f}, {7.071067691e-01f, 7.071067691e-01f}, {3.826834261e-01f, 9.238795042e-01f},
+	{8.968727589e-01f, 4.422886968e-01f}, {6.087614298e-01f, 7.933533192e-01f}, {1.950903237e-01f, 9.807852507e-01f},
+	{8.660253882e-01f, 5.000000000e-01f}, {5.000000000e-01f, 8.660253882e-01f}, {6.123234263e-17f, 1.000000000e+00f},
+	{8.314695954e-01f, 5.555702448e-01f}, {3.826834261e-01f, 9.238795042e-01f}, {-1.950903237e-01f, 9.807852507e-01f},
+	{7.933533192e-01f, 6.087614298e-01f}, {2.588190436e-01f, 9.659258127e-01f}, {-3.826834261e-01f, 9.238795042e-01f},
+	{7.518398166e-01f, 6.593458056e-01f}, {1.305261850e-01f, 9.914448857e-01f}, {-5.555702448e-01f, 8.314695954e-01f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{6.593458056e-01f, 7.518398166e-01f}, {-1.305261850e-01f, 9.914448857e-01f}, {-8.314695954e-01f, 5.555702448e-01f},
+	{6.087614298e-01f, 7.933533192e-01f}, {-2.588190436e-01f, 9.659258127e-01f}, {-9.238795042e-01f, 3.826834261e-01f},
+	{5.555702448e-01f, 8.314695954e-01f}, {-3.826834261e-01f, 9.238795042e-01f}, {-9.807852507e-01f, 1.950903237e-01f},
+	{5.000000000e-01f, 8.660253882e-01f}, {-5.000000000e-01f, 8.660253882e-01f}, {-1.000000000e+00f, 1.224646853e-16f},
+	{4.422886968e-01f, 8.968727589e-01f}, {-6.087614298e-01f, 7.933533192e-01f}, {-9.807852507e-01f, -1.950903237e-01f},
+	{3.826834261e-01f, 9.238795042e-01f}, {-7.071067691e-01f, 7.071067691e-01f}, {-9.238795042e-01f, -3.826834261e-01f},
+	{3.214394748e-01f, 9.469301105e-01f}, {-7.933533192e-01f, 6.087614298e-01f}, {-8.314695954e-01f, -5.555702448e-01f},
+	{2.588190436e-01f, 9.659258127e-01f}, {-8.660253882e-01f, 5.000000000e-01f}, {-7.071067691e-01f, -7.071067691e-01f},
+	{1.950903237e-01f, 9.807852507e-01f}, {-9.238795042e-01f, 3.826834261e-01f}, {-5.555702448e-01f, -8.314695954e-01f},
+	{1.305261850e-01f, 9.914448857e-01f}, {-9.659258127e-01f, 2.588190436e-01f}, {-3.826834261e-01f, -9.238795042e-01f},
+	{6.540312618e-02f, 9.978589416e-01f}, {-9.914448857e-01f, 1.305261850e-01f}, {-1.950903237e-01f, -9.807852507e-01f},
+};
+
+static const float fft_codelet_twiddles_96_1[18][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f}, {1.000000000e+00f, 0.000000000e+00f},
+	{9.659258127e-01f, 2.588190436e-01f}, {8.660253882e-01f, 5.000000000e-01f}, {7.071067691e-01f, 7.071067691e-01f},
+	{8.660253882e-01f, 5.000000000e-01f}, {5.000000000e-01f, 8.660253882e-01f}, {6.123234263e-17f, 1.000000000e+00f},
+	{7.071067691e-01f, 7.071067691e-01f}, {6.123234263e-17f, 1.000000000e+00f}, {-7.071067691e-01f, 7.071067691e-01f},
+	{5.000000000e-01f, 8.660253882e-01f}, {-5.000000000e-01f, 8.660253882e-01f}, {-1.000000000e+00f, 1.224646853e-16f},
+	{2.588190436e-01f, 9.659258127e-01f}, {-8.660253882e-01f, 5.000000000e-01f}, {-7.071067691e-01f, -7.071067691e-01f},
+};
+
+static const float fft_codelet_twiddles_96_2[3][2] =
+{
+	{1.000000000e+00f, 0.000000000e+00f},
+	{5.000000000e-01f, 8.660253882e-01f},
+	{-5.000000000e-01f, 8.660253882e-01f},
+};
+
+//inverse length 96: 4 4 2 3
+static void fft_codelet_inverse_96(const float complex* input, float complex* output)
+{
+	float complex scratch[96];
+	const float half_sqrt3 = 0.86602540378443864676;
+	//radix 4, m = 24, s = 1
+	for(unsigned int q = 0; q < 24; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_96_0[3 * q][0] + I * fft_codelet_twiddles_96_0[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_96_0[3 * q + 1][0] + I * fft_codelet_twiddles_96_0[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_96_0[3 * q + 2][0] + I * fft_codelet_twiddles_96_0[3 * q + 2][1];
+		float complex a0 = input[q];
+		float complex a1 = input[q + 24];
+		float complex a2 = input[q + 48];
+		float complex a3 = input[q + 72];
+		float complex t0 = a0 + a2;
+		float complex t1 = a0 - a2;
+		float complex t2 = a1 + a3;
+		float complex t3 = rot(a1 - a3, FFT_INVERSE);
+		scratch[4 * q] = t0 + t2;
+		scratch[4 * q + 1] = cmul(t1 + t3, w1);
+		scratch[4 * q + 2] = cmul(t0 - t2, w2);
+		scratch[4 * q + 3] = cmul(t1 - t3, w3);
+	}
+	//radix 4, m = 6, s = 4
+	for(unsigned int q = 0; q < 6; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_96_1[3 * q][0] + I * fft_codelet_twiddles_96_1[3 * q][1];
+		float complex w2 = fft_codelet_twiddles_96_1[3 * q + 1][0] + I * fft_codelet_twiddles_96_1[3 * q + 1][1];
+		float complex w3 = fft_codelet_twiddles_96_1[3 * q + 2][0] + I * fft_codelet_twiddles_96_1[3 * q + 2][1];
+		for(unsigned int k = 0; k < 4; ++k)
+		{
+			float complex a0 = scratch[k + 4 * q];
+			float complex a1 = scratch[k + 4 * q + 24];
+			float complex a2 = scratch[k + 4 * q + 48];
+			float complex a3 = scratch[k + 4 * q + 72];
+			float complex t0 = a0 + a2;
+			float complex t1 = a0 - a2;
+			float complex t2 = a1 + a3;
+			float complex t3 = rot(a1 - a3, FFT_INVERSE);
+			output[k + 16 * q] = t0 + t2;
+			output[k + 16 * q + 4] = cmul(t1 + t3, w1);
+			output[k + 16 * q + 8] = cmul(t0 - t2, w2);
+			output[k + 16 * q + 12] = cmul(t1 - t3, w3);
+		}
+	}
+	//radix 2, m = 3, s = 16
+	for(unsigned int q = 0; q < 3; ++q)
+	{
+		float complex w1 = fft_codelet_twiddles_96_2[q][0] + I * fft_codelet_twiddles_96_2[q][1];
+		for(unsigned int k = 0; k < 16; ++k)
+		{
+			float complex a0 = output[k + 16 * q];
+			float complex a1 = output[k + 16 * q + 48];
+			scratch[k + 32 * q] = a0 + a1;
+			scratch[k + 32 * q + 16] = cmul(a0 - a1, w1);
+		}
+	}
+	//radix 3, m = 1, s = 32
+	for(unsigned int k = 0; k < 32; ++k)
+	{
+		float complex a0 = scratch[k];
+		float complex a1 = scratch[k + 32];
+		float complex a2 = scratch[k + 64];
+		float complex t = a1 + a2;
+		float complex mid = a0 - 0.5f * t;
+		float complex d = half_sqrt3 * rot(a1 - a2, FFT_INVERSE);
+		output[k] = a0 + t;
+		output[k + 32] = mid + d;
+		output[k + 64] = mid - d;
+	}
+}
+
+typedef void (*fft_codelet)(const float complex* input, float complex* output);
+
+static fft_codelet fft_codelet_inverse(unsigned int num_points)
+{
+	switch(num_points)
+	{
+		case 256:
+			return fft_codelet_inverse_256;
+		case 192:
+			return fft_codelet_inverse_192;
+		case 128:
+			return fft_codelet_inverse_128;
+		case 96:
+			return fft_codelet_inverse_96;
+		default:
+			return NULL;
+	}
+}
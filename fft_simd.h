@@ -0,0 +1,169 @@
+//Vector versions of the radix 2, 3, 4 and 5 stages in fft.c, included once per instruction set.
+//The includer defines FFT_SIMD_SUFFIX, FFT_SIMD_TARGET, FFT_SIMD_FLOATS (floats per vector),
+//FFT_SIMD_PAIRS(a, b) (a, b repeated FFT_SIMD_FLOATS / 2 times) and FFT_SIMD_SWAP_MASK
+//(1, 0, 3, 2, ... up to FFT_SIMD_FLOATS). A vector holds FFT_SIMD_FLOATS / 2 interleaved complex
+//values along k, so s must be a multiple of that. The arithmetic is the scalar stages' operation
+//for operation, so every instruction set gives the same result.
+
+#define FFT_SIMD_CONCAT2(name, suffix) name##_##suffix
+#define FFT_SIMD_CONCAT(name, suffix) FFT_SIMD_CONCAT2(name, suffix)
+#define FFT_SIMD_NAME(name) FFT_SIMD_CONCAT(name, FFT_SIMD_SUFFIX)
+
+typedef float FFT_SIMD_NAME(fft_vector) __attribute__((vector_size(FFT_SIMD_FLOATS * 4)));
+typedef int FFT_SIMD_NAME(fft_vector_mask) __attribute__((vector_size(FFT_SIMD_FLOATS * 4)));
+#define VECTOR FFT_SIMD_NAME(fft_vector)
+#define LANES (FFT_SIMD_FLOATS / 2)
+#define LOAD(index) FFT_SIMD_NAME(fft_load)(x + (index))
+#define STORE(index, value) FFT_SIMD_NAME(fft_store)(y + (index), value)
+#define CMUL(a, j) FFT_SIMD_NAME(fft_cmul)(a, w##j##_real, w##j##_imag)
+#define ROT(a) (FFT_SIMD_NAME(fft_swap)(a) * rot_sign)
+//twiddle j of group q as (wr, wr) and (-wi, wi) in every lane
+#define TWIDDLE(j, index) \
+	VECTOR w##j##_real = ones * crealf(twiddles[index]); \
+	VECTOR w##j##_imag = negate_real * cimagf(twiddles[index])
+
+FFT_SIMD_TARGET static inline VECTOR FFT_SIMD_NAME(fft_load)(const float complex* source)
+{
+	VECTOR v;
+	__builtin_memcpy(&v, source, sizeof(v));
+	return v;
+}
+
+FFT_SIMD_TARGET static inline void FFT_SIMD_NAME(fft_store)(float complex* destination, VECTOR v)
+{
+	__builtin_memcpy(destination, &v, sizeof(v));
+}
+
+//(re, im) -> (im, re) in every lane
+FFT_SIMD_TARGET static inline VECTOR FFT_SIMD_NAME(fft_swap)(VECTOR v)
+{
+	const FFT_SIMD_NAME(fft_vector_mask) swap = {FFT_SIMD_SWAP_MASK};
+	return __builtin_shuffle(v, swap);
+}
+
+//same products and sums as cmul()
+FFT_SIMD_TARGET static inline VECTOR FFT_SIMD_NAME(fft_cmul)(VECTOR a, VECTOR w_real, VECTOR w_imag)
+{
+	return a * w_real + FFT_SIMD_NAME(fft_swap)(a) * w_imag;
+}
+
+FFT_SIMD_TARGET static void FFT_SIMD_NAME(fft_radix2)(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	const VECTOR ones = {FFT_SIMD_PAIRS(1.0f, 1.0f)};
+	const VECTOR negate_real = {FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	(void)direction;
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		TWIDDLE(1, q);
+		for(unsigned int k = 0; k < s; k = k + LANES)
+		{
+			VECTOR a0 = LOAD(k + s * q);
+			VECTOR a1 = LOAD(k + s * (q + m));
+			STORE(k + s * (2 * q), a0 + a1);
+			STORE(k + s * (2 * q + 1), CMUL(a0 - a1, 1));
+		}
+	}
+}
+
+FFT_SIMD_TARGET static void FFT_SIMD_NAME(fft_radix3)(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	const VECTOR ones = {FFT_SIMD_PAIRS(1.0f, 1.0f)};
+	const VECTOR negate_real = {FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	const VECTOR rot_sign = (direction < 0) ? (VECTOR){FFT_SIMD_PAIRS(1.0f, -1.0f)} : (VECTOR){FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	const float half_sqrt3 = 0.86602540378443864676;
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		TWIDDLE(1, 2 * q);
+		TWIDDLE(2, 2 * q + 1);
+		for(unsigned int k = 0; k < s; k = k + LANES)
+		{
+			VECTOR a0 = LOAD(k + s * q);
+			VECTOR a1 = LOAD(k + s * (q + m));
+			VECTOR a2 = LOAD(k + s * (q + 2 * m));
+			VECTOR t = a1 + a2;
+			VECTOR mid = a0 - 0.5f * t;
+			VECTOR d = half_sqrt3 * ROT(a1 - a2);
+			STORE(k + s * (3 * q), a0 + t);
+			STORE(k + s * (3 * q + 1), CMUL(mid + d, 1));
+			STORE(k + s * (3 * q + 2), CMUL(mid - d, 2));
+		}
+	}
+}
+
+FFT_SIMD_TARGET static void FFT_SIMD_NAME(fft_radix4)(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	const VECTOR ones = {FFT_SIMD_PAIRS(1.0f, 1.0f)};
+	const VECTOR negate_real = {FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	const VECTOR rot_sign = (direction < 0) ? (VECTOR){FFT_SIMD_PAIRS(1.0f, -1.0f)} : (VECTOR){FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		TWIDDLE(1, 3 * q);
+		TWIDDLE(2, 3 * q + 1);
+		TWIDDLE(3, 3 * q + 2);
+		for(unsigned int k = 0; k < s; k = k + LANES)
+		{
+			VECTOR a0 = LOAD(k + s * q);
+			VECTOR a1 = LOAD(k + s * (q + m));
+			VECTOR a2 = LOAD(k + s * (q + 2 * m));
+			VECTOR a3 = LOAD(k + s * (q + 3 * m));
+			VECTOR t0 = a0 + a2;
+			VECTOR t1 = a0 - a2;
+			VECTOR t2 = a1 + a3;
+			VECTOR t3 = ROT(a1 - a3);
+			STORE(k + s * (4 * q), t0 + t2);
+			STORE(k + s * (4 * q + 1), CMUL(t1 + t3, 1));
+			STORE(k + s * (4 * q + 2), CMUL(t0 - t2, 2));
+			STORE(k + s * (4 * q + 3), CMUL(t1 - t3, 3));
+		}
+	}
+}
+
+FFT_SIMD_TARGET static void FFT_SIMD_NAME(fft_radix5)(const float complex* x, float complex* y, unsigned int m, unsigned int s, const float complex* twiddles, int direction)
+{
+	const VECTOR ones = {FFT_SIMD_PAIRS(1.0f, 1.0f)};
+	const VECTOR negate_real = {FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	const VECTOR rot_sign = (direction < 0) ? (VECTOR){FFT_SIMD_PAIRS(1.0f, -1.0f)} : (VECTOR){FFT_SIMD_PAIRS(-1.0f, 1.0f)};
+	const float c1 = 0.30901699437494742410;	//cos(2*pi/5)
+	const float c2 = -0.80901699437494742410;	//cos(4*pi/5)
+	const float s1 = 0.95105651629515357212;	//sin(2*pi/5)
+	const float s2 = 0.58778525229247312917;	//sin(4*pi/5)
+	for(unsigned int q = 0; q < m; ++q)
+	{
+		TWIDDLE(1, 4 * q);
+		TWIDDLE(2, 4 * q + 1);
+		TWIDDLE(3, 4 * q + 2);
+		TWIDDLE(4, 4 * q + 3);
+		for(unsigned int k = 0; k < s; k = k + LANES)
+		{
+			VECTOR a0 = LOAD(k + s * q);
+			VECTOR a1 = LOAD(k + s * (q + m));
+			VECTOR a2 = LOAD(k + s * (q + 2 * m));
+			VECTOR a3 = LOAD(k + s * (q + 3 * m));
+			VECTOR a4 = LOAD(k + s * (q + 4 * m));
+			VECTOR t1 = a1 + a4;
+			VECTOR t2 = a2 + a3;
+			VECTOR d1 = ROT(a1 - a4);
+			VECTOR d2 = ROT(a2 - a3);
+			VECTOR m1 = a0 + c1 * t1 + c2 * t2;
+			VECTOR m2 = a0 + c2 * t1 + c1 * t2;
+			VECTOR n1 = s1 * d1 + s2 * d2;
+			VECTOR n2 = s2 * d1 - s1 * d2;
+			STORE(k + s * (5 * q), a0 + t1 + t2);
+			STORE(k + s * (5 * q + 1), CMUL(m1 + n1, 1));
+			STORE(k + s * (5 * q + 2), CMUL(m2 + n2, 2));
+			STORE(k + s * (5 * q + 3), CMUL(m2 - n2, 3));
+			STORE(k + s * (5 * q + 4), CMUL(m1 - n1, 4));
+		}
+	}
+}
+
+#undef VECTOR
+#undef LANES
+#undef LOAD
+#undef STORE
+#undef CMUL
+#undef ROT
+#undef TWIDDLE
+#undef FFT_SIMD_NAME
+#undef FFT_SIMD_CONCAT
+#undef FFT_SIMD_CONCAT2
@@ -1127,9 +1127,36 @@ static unsigned getTreeInflateDynamic(HuffmanTree* tree_ll, HuffmanTree* tree_d,
   return error;
 }
 
+/*Optional receiver of the inflated data. With a sink, out does not grow to the whole decompressed size:
+whenever more than INFLATE_FLUSH_SIZE bytes past the window are pending they are handed to flush, and
+out is cut back to the last INFLATE_WINDOW bytes, the furthest a backward distance can reach.*/
+typedef struct InflateSink
+{
+  unsigned (*flush)(void* user, const unsigned char* data, size_t size); /*nonzero return stops inflating*/
+  void* user;
+  size_t flushed; /*the bytes of out before this were already given to flush*/
+} InflateSink;
+
+#define INFLATE_WINDOW 32768
+#define INFLATE_FLUSH_SIZE 65536
+
+/*gives everything pending in out to the sink and keeps only the window*/
+static unsigned inflateFlush(ucvector* out, size_t* pos, InflateSink* sink)
+{
+  size_t keep = *pos < INFLATE_WINDOW ? *pos : INFLATE_WINDOW;
+  size_t i;
+  unsigned error = sink->flush(sink->user, out->data + sink->flushed, *pos - sink->flushed);
+  if(error) return error;
+  for(i = 0; i != keep; ++i) out->data[i] = out->data[*pos - keep + i];
+  *pos = keep;
+  out->size = keep;
+  sink->flushed = keep;
+  return 0;
+}
+
 /*inflate a block with dynamic of fixed Huffman tree*/
 static unsigned inflateHuffmanBlock(ucvector* out, const unsigned char* in, size_t* bp,
-                                    size_t* pos, size_t inlength, unsigned btype)
+                                    size_t* pos, size_t inlength, unsigned btype, InflateSink* sink)
 {
   unsigned error = 0;
   HuffmanTree tree_ll; /*the huffman tree for literal and length codes*/
@@ -1145,7 +1172,13 @@ static unsigned inflateHuffmanBlock(ucvector* out, const unsigned char* in, size
   while(!error) /*decode all symbols until end reached, breaks at end code*/
   {
     /*code_ll is literal, length or end code*/
-    unsigned code_ll = huffmanDecodeSymbol(in, bp, &tree_ll, inbitlength);
+    unsigned code_ll;
+    if(sink && *pos >= INFLATE_WINDOW + INFLATE_FLUSH_SIZE)
+    {
+      error = inflateFlush(out, pos, sink);
+      if(error) break;
+    }
+    code_ll = huffmanDecodeSymbol(in, bp, &tree_ll, inbitlength);
     if(code_ll <= 255) /*literal symbol*/
     {
       /*ucvector_push_back would do the same, but for some reason the two lines below run 10% faster*/
@@ -1250,9 +1283,10 @@ static unsigned inflateNoCompression(ucvector* out, const unsigned char* in, siz
   return error;
 }
 
+/*sink may be 0, then out receives all of the decompressed data*/
 static unsigned lodepng_inflatev(ucvector* out,
                                  const unsigned char* in, size_t insize,
-                                 const LodePNGDecompressSettings* settings)
+                                 const LodePNGDecompressSettings* settings, InflateSink* sink)
 {
   /*bit pointer in the "in" data, current byte is bp >> 3, current bit is bp & 0x7 (from lsb to msb of the byte)*/
   size_t bp = 0;
@@ -1272,11 +1306,14 @@ static unsigned lodepng_inflatev(ucvector* out,
 
     if(BTYPE == 3) return 20; /*error: invalid BTYPE*/
     else if(BTYPE == 0) error = inflateNoCompression(out, in, &bp, &pos, insize); /*no compression*/
-    else error = inflateHuffmanBlock(out, in, &bp, &pos, insize, BTYPE); /*compression, BTYPE 01 or 10*/
+    else error = inflateHuffmanBlock(out, in, &bp, &pos, insize, BTYPE, sink); /*compression, BTYPE 01 or 10*/
 
     if(error) return error;
+    if(sink && pos >= INFLATE_WINDOW + INFLATE_FLUSH_SIZE) error = inflateFlush(out, &pos, sink);
+    if(error) return error;
   }
 
+  if(sink) error = inflateFlush(out, &pos, sink);
   return error;
 }
 
@@ -1287,7 +1324,7 @@ unsigned lodepng_inflate(unsigned char** out, size_t* outsize,
   unsigned error;
   ucvector v;
   ucvector_init_buffer(&v, *out, *outsize);
-  error = lodepng_inflatev(&v, in, insize, settings);
+  error = lodepng_inflatev(&v, in, insize, settings, 0);
   *out = v.data;
   *outsize = v.size;
   return error;
@@ -2123,10 +2160,8 @@ static unsigned adler32(const unsigned char* data, unsigned len)
 
 #ifdef LODEPNG_COMPILE_DECODER
 
-unsigned lodepng_zlib_decompress(unsigned char** out, size_t* outsize, const unsigned char* in,
-                                 size_t insize, const LodePNGDecompressSettings* settings)
+static unsigned zlib_check_header(const unsigned char* in, size_t insize)
 {
-  unsigned error = 0;
   unsigned CM, CINFO, FDICT;
 
   if(insize < 2) return 53; /*error, size of zlib data too small*/
@@ -2155,6 +2190,15 @@ unsigned lodepng_zlib_decompress(unsigned char** out, size_t* outsize, const uns
     return 26;
   }
 
+  return 0;
+}
+
+unsigned lodepng_zlib_decompress(unsigned char** out, size_t* outsize, const unsigned char* in,
+                                 size_t insize, const LodePNGDecompressSettings* settings)
+{
+  unsigned error = zlib_check_header(in, insize);
+  if(error) return error;
+
   error = inflate(out, outsize, in + 2, insize - 2, settings);
   if(error) return error;
 
@@ -2181,6 +2225,55 @@ static unsigned zlib_decompress(unsigned char** out, size_t* outsize, const unsi
   }
 }
 
+/*the flush target of zlib_decompress_stream: checksums the data before passing it on*/
+typedef struct ZlibStream
+{
+  unsigned (*flush)(void* user, const unsigned char* data, size_t size);
+  void* user;
+  unsigned adler;
+} ZlibStream;
+
+static unsigned zlibStreamFlush(void* user, const unsigned char* data, size_t size)
+{
+  ZlibStream* stream = (ZlibStream*)user;
+  stream->adler = update_adler32(stream->adler, data, (unsigned)size);
+  return stream->flush(stream->user, data, size);
+}
+
+/*Like zlib_decompress, but hands the decompressed data to flush in pieces as it is inflated instead of
+returning all of it, so only the inflate window is kept in memory. Ignores the custom_zlib and
+custom_inflate settings, they can only return the whole data.*/
+static unsigned zlib_decompress_stream(const unsigned char* in, size_t insize,
+                                       const LodePNGDecompressSettings* settings,
+                                       unsigned (*flush)(void* user, const unsigned char* data, size_t size),
+                                       void* user)
+{
+  ucvector window;
+  ZlibStream stream;
+  InflateSink sink;
+  unsigned error = zlib_check_header(in, insize);
+  if(error) return error;
+
+  stream.flush = flush;
+  stream.user = user;
+  stream.adler = 1;
+  sink.flush = zlibStreamFlush;
+  sink.user = &stream;
+  sink.flushed = 0;
+  ucvector_init(&window);
+  error = lodepng_inflatev(&window, in + 2, insize - 2, settings, &sink);
+  ucvector_cleanup(&window);
+  if(error) return error;
+
+  if(!settings->ignore_adler32)
+  {
+    unsigned ADLER32 = lodepng_read32bitInt(&in[insize - 4]);
+    if(stream.adler != ADLER32) return 58; /*error, adler checksum not correct, data must be corrupted*/
+  }
+
+  return 0; /*no error*/
+}
+
 #endif /*LODEPNG_COMPILE_DECODER*/
 
 #ifdef LODEPNG_COMPILE_ENCODER
@@ -4520,19 +4613,16 @@ static unsigned readChunk_pHYs(LodePNGInfo* info, const unsigned char* data, siz
 }
 #endif /*LODEPNG_COMPILE_ANCILLARY_CHUNKS*/
 
-/*read a PNG, the result will be in the same color type as the PNG (hence "generic")*/
-static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h,
-                          LodePNGState* state,
-                          const unsigned char* in, size_t insize)
+/*read the header and all chunks up to IEND into state->info_png, the concatenated IDAT data goes in idat
+(which must be initialized). Errors are stored in state->error.*/
+static void decodeChunks(ucvector* idat, unsigned* w, unsigned* h,
+                         LodePNGState* state,
+                         const unsigned char* in, size_t insize)
 {
   unsigned char IEND = 0;
   const unsigned char* chunk;
   size_t i;
-  ucvector idat; /*the data from idat chunks*/
-  ucvector scanlines;
-  size_t predict;
   size_t numpixels;
-  size_t outsize = 0;
 
   /*for unknown chunk order*/
   unsigned unknown = 0;
@@ -4540,9 +4630,6 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h,
   unsigned critical_pos = 1; /*1 = after IHDR, 2 = after PLTE, 3 = after IDAT*/
 #endif /*LODEPNG_COMPILE_ANCILLARY_CHUNKS*/
 
-  /*provide some proper output values if error will happen*/
-  *out = 0;
-
   state->error = lodepng_inspect(w, h, state, in, insize); /*reads header and resets other parameters in state->info_png*/
   if(state->error) return;
 
@@ -4554,7 +4641,6 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h,
   bytes with 16-bit RGBA, the rest is room for filter bytes.*/
   if(numpixels > 268435455) CERROR_RETURN(state->error, 92);
 
-  ucvector_init(&idat);
   chunk = &in[33]; /*first byte of the first chunk after the header*/
 
   /*loop through the chunks, ignoring unknown chunks and stopping at IEND chunk.
@@ -4582,9 +4668,9 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h,
     /*IDAT chunk, containing compressed image data*/
     if(lodepng_chunk_type_equals(chunk, "IDAT"))
     {
-      size_t oldsize = idat.size;
-      if(!ucvector_resize(&idat, oldsize + chunkLength)) CERROR_BREAK(state->error, 83 /*alloc fail*/);
-      for(i = 0; i != chunkLength; ++i) idat.data[oldsize + i] = data[i];
+      size_t oldsize = idat->size;
+      if(!ucvector_resize(idat, oldsize + chunkLength)) CERROR_BREAK(state->error, 83 /*alloc fail*/);
+      for(i = 0; i != chunkLength; ++i) idat->data[oldsize + i] = data[i];
 #ifdef LODEPNG_COMPILE_ANCILLARY_CHUNKS
       critical_pos = 3;
 #endif /*LODEPNG_COMPILE_ANCILLARY_CHUNKS*/
@@ -4677,6 +4763,29 @@ static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h,
 
     if(!IEND) chunk = lodepng_chunk_next_const(chunk);
   }
+}
+
+/*read a PNG, the result will be in the same color type as the PNG (hence "generic")*/
+static void decodeGeneric(unsigned char** out, unsigned* w, unsigned* h,
+                          LodePNGState* state,
+                          const unsigned char* in, size_t insize)
+{
+  size_t i;
+  ucvector idat; /*the data from idat chunks*/
+  ucvector scanlines;
+  size_t predict;
+  size_t outsize = 0;
+
+  /*provide some proper output values if error will happen*/
+  *out = 0;
+
+  ucvector_init(&idat);
+  decodeChunks(&idat, w, h, state, in, insize);
+  if(state->error)
+  {
+    ucvector_cleanup(&idat);
+    return;
+  }
 
   ucvector_init(&scanlines);
   /*predict output size, to allocate exact size for output buffer to avoid more dynamic allocation.
@@ -4767,6 +4876,167 @@ unsigned lodepng_decode(unsigned char** out, unsigned* w, unsigned* h,
   return state->error;
 }
 
+/*lodepng_decode_rows state: collects the inflated data into scanlines, unfilters each against the previous
+one and gives it, color converted if needed, to the callback*/
+typedef struct RowDecoder
+{
+  const LodePNGState* state;
+  unsigned w, h;
+  unsigned y; /*the next row to deliver*/
+  size_t bytewidth, linebytes;
+  unsigned char* line; /*filter type byte and filtered scanline being collected*/
+  size_t linepos; /*bytes of line collected so far*/
+  unsigned char* recon; /*unfiltered scanline*/
+  unsigned char* precon; /*previous unfiltered scanline*/
+  unsigned char* converted; /*recon in the info_raw color type, 0 if no conversion is needed*/
+  lodepng_row_callback callback;
+  void* user;
+} RowDecoder;
+
+static unsigned rowDecoderFlush(void* user, const unsigned char* data, size_t size)
+{
+  RowDecoder* decoder = (RowDecoder*)user;
+  while(size > 0)
+  {
+    size_t amount = decoder->linebytes + 1 - decoder->linepos;
+    unsigned char* swap;
+    unsigned error;
+
+    if(decoder->y == decoder->h) return 91; /*decompressed size doesn't match prediction*/
+    if(amount > size) amount = size;
+    for(; amount > 0; --amount, --size) decoder->line[decoder->linepos++] = *data++;
+    if(decoder->linepos != decoder->linebytes + 1) break;
+
+    error = unfilterScanline(decoder->recon, decoder->line + 1, decoder->y ? decoder->precon : 0,
+                             decoder->bytewidth, decoder->line[0], decoder->linebytes);
+    if(!error && decoder->converted)
+    {
+      error = lodepng_convert(decoder->converted, decoder->recon, &decoder->state->info_raw,
+                              &decoder->state->info_png.color, decoder->w, 1);
+    }
+    if(!error)
+    {
+      error = decoder->callback(decoder->user, decoder->y,
+                                decoder->converted ? decoder->converted : decoder->recon);
+    }
+    if(error) return error;
+
+    swap = decoder->precon;
+    decoder->precon = decoder->recon;
+    decoder->recon = swap;
+    decoder->linepos = 0;
+    ++decoder->y;
+  }
+  return 0;
+}
+
+/*gives the rows of a whole decoded image to the callback, moving them to a byte boundary if needed*/
+static unsigned deliverImageRows(const unsigned char* image, unsigned w, unsigned h,
+                                 const LodePNGColorMode* mode, lodepng_row_callback callback, void* user)
+{
+  unsigned bpp = lodepng_get_bpp(mode);
+  size_t linebits = (size_t)w * bpp;
+  unsigned char* row = 0;
+  unsigned error = 0;
+  unsigned y;
+
+  if(linebits % 8 != 0)
+  {
+    row = (unsigned char*)lodepng_malloc((linebits + 7) / 8);
+    if(!row) return 83; /*alloc fail*/
+  }
+  for(y = 0; y != h && !error; ++y)
+  {
+    if(row)
+    {
+      size_t ibp = y * linebits, obp = 0;
+      size_t i;
+      for(i = 0; i != linebits; ++i)
+      {
+        setBitOfReversedStream(&obp, row, readBitFromReversedStream(&ibp, image));
+      }
+      error = callback(user, y, row);
+    }
+    else error = callback(user, y, image + y * (linebits / 8));
+  }
+  lodepng_free(row);
+  return error;
+}
+
+unsigned lodepng_decode_rows(unsigned* w, unsigned* h, LodePNGState* state,
+                             const unsigned char* in, size_t insize,
+                             lodepng_row_callback callback, void* user)
+{
+  ucvector idat;
+  RowDecoder decoder;
+  const LodePNGColorMode* color = &state->info_png.color;
+  unsigned convert;
+
+  ucvector_init(&idat);
+  decodeChunks(&idat, w, h, state, in, insize);
+
+  /*Adam7 rows are only complete after the last pass, and custom decompressors can't be streamed*/
+  if(!state->error && (state->info_png.interlace_method != 0 || state->decoder.zlibsettings.custom_zlib
+                       || state->decoder.zlibsettings.custom_inflate))
+  {
+    unsigned char* image = 0;
+    ucvector_cleanup(&idat);
+    state->error = lodepng_decode(&image, w, h, state, in, insize);
+    if(!state->error) state->error = deliverImageRows(image, *w, *h, &state->info_raw, callback, user);
+    lodepng_free(image);
+    return state->error;
+  }
+
+  convert = state->decoder.color_convert && !lodepng_color_mode_equal(&state->info_raw, color);
+  if(!state->error && !state->decoder.color_convert)
+  {
+    state->error = lodepng_color_mode_copy(&state->info_raw, color);
+  }
+  if(!state->error && convert && !(state->info_raw.colortype == LCT_RGB || state->info_raw.colortype == LCT_RGBA)
+     && !(state->info_raw.bitdepth == 8))
+  {
+    state->error = 56; /*unsupported color mode conversion*/
+  }
+
+  decoder.state = state;
+  decoder.w = *w;
+  decoder.h = *h;
+  decoder.y = 0;
+  decoder.bytewidth = (lodepng_get_bpp(color) + 7) / 8;
+  decoder.linebytes = lodepng_get_raw_size_idat(*w, 1, color);
+  decoder.linepos = 0;
+  decoder.line = decoder.recon = decoder.precon = decoder.converted = 0;
+  decoder.callback = callback;
+  decoder.user = user;
+  if(!state->error)
+  {
+    decoder.line = (unsigned char*)lodepng_malloc(decoder.linebytes + 1);
+    decoder.recon = (unsigned char*)lodepng_malloc(decoder.linebytes);
+    decoder.precon = (unsigned char*)lodepng_malloc(decoder.linebytes);
+    if(convert) decoder.converted = (unsigned char*)lodepng_malloc(lodepng_get_raw_size(*w, 1, &state->info_raw));
+    if(!decoder.line || !decoder.recon || !decoder.precon || (convert && !decoder.converted))
+    {
+      state->error = 83; /*alloc fail*/
+    }
+  }
+  if(!state->error)
+  {
+    state->error = zlib_decompress_stream(idat.data, idat.size, &state->decoder.zlibsettings,
+                                          rowDecoderFlush, &decoder);
+    if(!state->error && (decoder.y != decoder.h || decoder.linepos != 0))
+    {
+      state->error = 91; /*decompressed size doesn't match prediction*/
+    }
+  }
+
+  ucvector_cleanup(&idat);
+  lodepng_free(decoder.line);
+  lodepng_free(decoder.recon);
+  lodepng_free(decoder.precon);
+  lodepng_free(decoder.converted);
+  return state->error;
+}
+
 unsigned lodepng_decode_memory(unsigned char** out, unsigned* w, unsigned* h, const unsigned char* in,
                                size_t insize, LodePNGColorType colortype, unsigned bitdepth)
 {
@@ -659,6 +659,26 @@ information is placed in the info_png field of the LodePNGState.
 unsigned lodepng_inspect(unsigned* w, unsigned* h,
                          LodePNGState* state,
                          const unsigned char* in, size_t insize);
+
+/*
+Called by lodepng_decode_rows for every row y of the image, from top to bottom. row holds the
+pixels in the color type of state->info_raw, starting at a byte boundary even if the pixels are
+smaller than a byte. It is only valid during the call. A nonzero return value stops decoding and
+is returned as the error.
+*/
+typedef unsigned (*lodepng_row_callback)(void* user, unsigned y, const unsigned char* row);
+
+/*
+Same as lodepng_decode, but instead of returning the whole image it inflates the image data
+incrementally and gives each row to callback as soon as it is unfiltered and color converted.
+Besides the compressed data only the 32K inflate window and a few scanlines are kept in memory.
+Use lodepng_inspect first to learn the size before the rows arrive. Adam7 interlaced images and
+custom zlib or inflate functions are decoded whole first, then handed over row by row.
+*/
+unsigned lodepng_decode_rows(unsigned* w, unsigned* h,
+                             LodePNGState* state,
+                             const unsigned char* in, size_t insize,
+                             lodepng_row_callback callback, void* user);
 #endif /*LODEPNG_COMPILE_DECODER*/
 
 
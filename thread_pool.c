@@ -0,0 +1,221 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "thread_pool.h"
+
+typedef struct POOL_JOB
+{
+	pool_task task;
+	void* context;
+	unsigned int count;
+	unsigned int chunk_size;
+	unsigned int next;	//first item not yet taken
+	unsigned int finished;	//items done
+	struct POOL_JOB* next_job;
+} pool_job;
+
+//everything below is guarded by lock, wake is broadcast whenever work appears or finishes
+static pthread_t* workers = NULL;
+static unsigned int num_workers = 0;
+static void (*worker_exit)(void) = NULL;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+static pool_job* jobs = NULL;	//jobs that are running, newest first
+static task_graph* graph = NULL;	//the graph being run
+static int stopping = 0;
+
+//runs one chunk of job, called with lock held and returns with it held
+static void pool_run_chunk(pool_job* job)
+{
+	unsigned int first = job->next;
+	unsigned int last = (job->count - first > job->chunk_size) ? first + job->chunk_size : job->count;
+	job->next = last;
+	pthread_mutex_unlock(&lock);
+	job->task(job->context, first, last);
+	pthread_mutex_lock(&lock);
+	job->finished = job->finished + (last - first);
+	if(job->finished == job->count)
+		pthread_cond_broadcast(&wake);
+}
+
+//runs a chunk of any job that has some left, returns 0 if there was none
+static int pool_help(void)
+{
+	for(pool_job* job = jobs; job; job = job->next_job)
+	{
+		if(job->next < job->count)
+		{
+			pool_run_chunk(job);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//marks a task finished and releases the tasks waiting for it
+static void graph_finish(task_graph* running, unsigned int id)
+{
+	graph_node* node = &running->nodes[id];
+	for(unsigned int d = 0; d < node->num_dependents; ++d)
+	{
+		--running->nodes[node->dependents[d]].waiting;
+	}
+	++running->num_finished;
+}
+
+//starts the first ready task of the running graph, returns 0 if none is ready
+//called with lock held and returns with it held
+static int graph_help(void)
+{
+	if(!graph)
+		return 0;
+	task_graph* running = graph;
+	for(unsigned int id = 0; id < running->num_tasks; ++id)
+	{
+		graph_node* node = &running->nodes[id];
+		if(node->started || node->waiting)
+			continue;
+		node->started = 1;
+		pthread_mutex_unlock(&lock);
+		node->task(running->context, node->argument);
+		pthread_mutex_lock(&lock);
+		graph_finish(running, id);
+		pthread_cond_broadcast(&wake);
+		return 1;
+	}
+	return 0;
+}
+
+static void* pool_worker(void* argument)
+{
+	(void)argument;
+	pthread_mutex_lock(&lock);
+	while(!stopping)
+	{
+		if(!graph_help() && !pool_help())
+			pthread_cond_wait(&wake, &lock);
+	}
+	pthread_mutex_unlock(&lock);
+	if(worker_exit)
+		worker_exit();
+	return NULL;
+}
+
+void pool_start(unsigned int num_threads, void (*thread_exit)(void))
+{
+	if(num_threads < 2)
+		return;
+	worker_exit = thread_exit;
+	num_workers = num_threads - 1;
+	workers = (pthread_t*)malloc(sizeof(pthread_t) * num_workers);
+	for(unsigned int d = 0; d < num_workers; ++d)
+	{
+		pthread_create(&workers[d], NULL, pool_worker, NULL);
+	}
+}
+
+void pool_run(pool_task task, void* context, unsigned int count, unsigned int chunk_size)
+{
+	if(chunk_size == 0)
+		chunk_size = 1;
+	if(!num_workers)
+	{
+		for(unsigned int first = 0; first < count; first = first + chunk_size)
+		{
+			task(context, first, (count - first > chunk_size) ? first + chunk_size : count);
+		}
+		return;
+	}
+	pool_job job = {task, context, count, chunk_size, 0, 0, NULL};
+	pthread_mutex_lock(&lock);
+	job.next_job = jobs;
+	jobs = &job;
+	pthread_cond_broadcast(&wake);
+	//the caller only takes its own chunks, so it never gets stuck in someone else's long chunk
+	while(job.finished < job.count)
+	{
+		if(job.next < job.count)
+			pool_run_chunk(&job);
+		else
+			pthread_cond_wait(&wake, &lock);
+	}
+	pool_job** link = &jobs;
+	while(*link != &job)
+		link = &(*link)->next_job;
+	*link = job.next_job;
+	pthread_mutex_unlock(&lock);
+}
+
+void pool_stop(void)
+{
+	if(!num_workers)
+		return;
+	pthread_mutex_lock(&lock);
+	stopping = 1;
+	pthread_cond_broadcast(&wake);
+	pthread_mutex_unlock(&lock);
+	for(unsigned int d = 0; d < num_workers; ++d)
+	{
+		pthread_join(workers[d], NULL);
+	}
+	free(workers);
+	workers = NULL;
+	num_workers = 0;
+	stopping = 0;
+}
+
+void graph_init(task_graph* new_graph, void* context)
+{
+	new_graph->context = context;
+	new_graph->num_tasks = 0;
+	new_graph->num_finished = 0;
+}
+
+unsigned int graph_add(task_graph* target, graph_task task, unsigned int argument)
+{
+	unsigned int id = target->num_tasks++;
+	graph_node* node = &target->nodes[id];
+	node->task = task;
+	node->argument = argument;
+	node->waiting = 0;
+	node->started = 0;
+	node->num_dependents = 0;
+	return id;
+}
+
+void graph_depend(task_graph* target, unsigned int task, unsigned int dependency)
+{
+	graph_node* node = &target->nodes[dependency];
+	node->dependents[node->num_dependents++] = task;
+	++target->nodes[task].waiting;
+}
+
+void graph_run(task_graph* target)
+{
+	if(!num_workers)
+	{
+		while(target->num_finished < target->num_tasks)
+		{
+			for(unsigned int id = 0; id < target->num_tasks; ++id)
+			{
+				graph_node* node = &target->nodes[id];
+				if(node->started || node->waiting)
+					continue;
+				node->started = 1;
+				node->task(target->context, node->argument);
+				graph_finish(target, id);
+				break;
+			}
+		}
+		return;
+	}
+	pthread_mutex_lock(&lock);
+	graph = target;
+	pthread_cond_broadcast(&wake);
+	while(target->num_finished < target->num_tasks)
+	{
+		if(!graph_help() && !pool_help())
+			pthread_cond_wait(&wake, &lock);
+	}
+	graph = NULL;
+	pthread_mutex_unlock(&lock);
+}
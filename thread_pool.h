@@ -0,0 +1,46 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+//Splits [0, count) into chunks of at most chunk_size items and calls task(context, first, last) for
+//each chunk on the pool's threads and the calling thread, returning when every chunk is done.
+//Without a started pool (or with one thread) the chunks simply run on the calling thread.
+//pool_run may be called from inside a graph task or another job, idle threads help with every job.
+typedef void (*pool_task)(void* context, unsigned int first, unsigned int last);
+
+//num_threads counts the calling thread, thread_exit (may be NULL) runs on each worker before it ends
+void pool_start(unsigned int num_threads, void (*thread_exit)(void));
+void pool_run(pool_task task, void* context, unsigned int count, unsigned int chunk_size);
+void pool_stop(void);
+
+//Task graph: each task runs task(context, argument) once all of its dependencies have finished.
+//Ready tasks start in the order they were added, so on one thread a graph added in dependency
+//order runs exactly in that order. One graph runs at a time.
+#define GRAPH_MAX_TASKS 32
+#define GRAPH_MAX_DEPENDENTS 8
+
+typedef void (*graph_task)(void* context, unsigned int argument);
+
+typedef struct GRAPH_NODE
+{
+	graph_task task;
+	unsigned int argument;
+	unsigned int waiting;	//dependencies not finished yet
+	unsigned int started;
+	unsigned int num_dependents;
+	unsigned int dependents[GRAPH_MAX_DEPENDENTS];
+} graph_node;
+
+typedef struct TASK_GRAPH
+{
+	void* context;
+	unsigned int num_tasks;
+	unsigned int num_finished;
+	graph_node nodes[GRAPH_MAX_TASKS];
+} task_graph;
+
+void graph_init(task_graph* graph, void* context);
+unsigned int graph_add(task_graph* graph, graph_task task, unsigned int argument);	//returns the task's id
+void graph_depend(task_graph* graph, unsigned int task, unsigned int dependency);	//task waits for dependency
+void graph_run(task_graph* graph);
+
+#endif